@@ -0,0 +1,95 @@
+#include "LeaderboardBackend.h"
+
+TUniquePtr<FLeaderboardBackend> FLeaderboardBackend::Create(IOnlineSubsystem* Subsystem, bool bHasInjectedInterfaces)
+{
+    if (Subsystem)
+    {
+        const FString SubsystemName = Subsystem->GetSubsystemName().ToString();
+        if (SubsystemName == "EOS" || SubsystemName == "Epic")
+        {
+            return MakeUnique<FEpicLeaderboardBackend>();
+        }
+    }
+    if (Subsystem || bHasInjectedInterfaces)
+    {
+        return MakeUnique<FSteamLeaderboardBackend>();
+    }
+    return MakeUnique<FNullLeaderboardBackend>();
+}
+
+void FLeaderboardBackend::Bind(IOnlineSubsystem* Subsystem, IOnlineLeaderboardsPtr InLeaderboards, IOnlineIdentityPtr InIdentity)
+{
+    Leaderboards = InLeaderboards.IsValid() ? InLeaderboards : (Subsystem ? Subsystem->GetLeaderboardsInterface() : nullptr);
+    Identity = InIdentity.IsValid() ? InIdentity : (Subsystem ? Subsystem->GetIdentityInterface() : nullptr);
+    bWritesReady = InLeaderboards.IsValid() || (Subsystem && IsWriteReady(*Subsystem));
+}
+
+bool FLeaderboardBackend::CanWrite() const
+{
+    if (!Leaderboards.IsValid())
+    {
+        return false;
+    }
+    if (!bWritesReady)
+    {
+        // Latches once ready; until then this is the same per-call check the platforms always needed
+        IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
+        bWritesReady = Subsystem && IsWriteReady(*Subsystem);
+    }
+    return bWritesReady;
+}
+
+bool FLeaderboardBackend::CanRead(int32 LocalUserNum, bool bNeedsLocalUser) const
+{
+    if (!Leaderboards.IsValid())
+    {
+        return false;
+    }
+    if (!bNeedsLocalUser || !Identity.IsValid())
+    {
+        return true;
+    }
+
+    FUniqueNetIdPtr UserId = Identity->GetUniquePlayerId(LocalUserNum);
+    return UserId.IsValid() && IsUserReady(*Identity, *UserId);
+}
+
+// ===== Steam =====
+
+void FSteamLeaderboardPolicy::ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping)
+{
+    OutMapping.LeaderboardName = FName(*Row.SteamLeaderboardName);
+    OutMapping.StatName = FName(*Row.SteamStatName);
+    OutMapping.WriteLeaderboardName = DisplayName;
+    OutMapping.RatedStat = OutMapping.LeaderboardName;
+}
+
+// ===== Epic =====
+
+void FEpicLeaderboardPolicy::ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping)
+{
+    OutMapping.LeaderboardName = FName(*Row.EpicLeaderboardName);
+    OutMapping.StatName = FName(*Row.EpicStatName);
+    OutMapping.WriteLeaderboardName = OutMapping.LeaderboardName;
+    OutMapping.RatedStat = OutMapping.StatName;
+}
+
+bool FEpicLeaderboardPolicy::IsWriteReady(IOnlineSubsystem& Subsystem)
+{
+    return Subsystem.GetStatsInterface().IsValid();
+}
+
+bool FEpicLeaderboardPolicy::IsUserReady(const IOnlineIdentity& Identity, const FUniqueNetId& UserId)
+{
+    return Identity.GetLoginStatus(UserId) == ELoginStatus::LoggedIn;
+}
+
+// ===== Null =====
+
+void FNullLeaderboardPolicy::ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping)
+{
+    OutMapping.LeaderboardName = DisplayName;
+    OutMapping.StatName = DisplayName;
+    OutMapping.WriteLeaderboardName = DisplayName;
+    OutMapping.RatedStat = DisplayName;
+}
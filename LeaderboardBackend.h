@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystem.h"
+#include "Interfaces/OnlineLeaderboardInterface.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "LeaderboardTypes.h"
+
+// One mapping row resolved for the active platform, built once at Initialize so reads and writes never touch the DataTable.
+struct FLeaderboardMapping
+{
+    FName DisplayName;
+    FName LeaderboardName;
+    FName StatName;
+    // Steam writes go to the display-named board rated by the API name, Epic writes to the API board rated by the stat
+    FName WriteLeaderboardName;
+    FName RatedStat;
+    FColumnMetaData ColumnMetaData = FColumnMetaData(NAME_None, EOnlineKeyValuePairDataType::Int32);
+    // Same on every platform, copied from the row by the manager
+    FLeaderboardScoreGate ScoreGate;
+};
+
+// The online services a manager reads from and writes to, picked once at Initialize.
+// Interfaces are looked up when the backend is bound rather than on every call; the manager keeps a single
+// read/write path and only asks the backend about what actually differs between platforms.
+class FLeaderboardBackend
+{
+public:
+    virtual ~FLeaderboardBackend() = default;
+
+    // Picks the backend for the running subsystem. Without a subsystem or injected interfaces that is the null backend.
+    static TUniquePtr<FLeaderboardBackend> Create(IOnlineSubsystem* Subsystem, bool bHasInjectedInterfaces);
+
+    // Caches the interfaces to use. Injected ones win over the subsystem's and skip its readiness checks.
+    void Bind(IOnlineSubsystem* Subsystem, IOnlineLeaderboardsPtr InLeaderboards, IOnlineIdentityPtr InIdentity);
+
+    // Also stamped into snapshots, so rows cached under one platform's board names are never loaded under another's.
+    virtual ELeaderboardPlatform GetPlatform() const = 0;
+    virtual void ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping) const = 0;
+
+    // A platform that wasn't ready when bound, e.g. EOS before its stats interface is up, is asked again on every call
+    // until it is. Refused writes stay queued in the manager.
+    bool CanWrite() const;
+    // Reads for a local user need that user signed in the way the platform expects. Reads by player ID don't,
+    // since a dedicated server has no local user at all.
+    bool CanRead(int32 LocalUserNum, bool bNeedsLocalUser) const;
+
+    const IOnlineLeaderboardsPtr& GetLeaderboards() const { return Leaderboards; }
+    const IOnlineIdentityPtr& GetIdentity() const { return Identity; }
+
+protected:
+    virtual bool IsWriteReady(IOnlineSubsystem& Subsystem) const = 0;
+    virtual bool IsUserReady(const IOnlineIdentity& InIdentity, const FUniqueNetId& UserId) const = 0;
+
+private:
+    IOnlineLeaderboardsPtr Leaderboards;
+    IOnlineIdentityPtr Identity;
+    mutable bool bWritesReady = false;
+};
+
+// Adapts a stateless policy to the backend interface. A new backend is a policy struct with the same four members
+// as the ones below plus a line in FLeaderboardBackend::Create.
+template <typename TPolicy>
+class TLeaderboardBackend final : public FLeaderboardBackend
+{
+public:
+    virtual ELeaderboardPlatform GetPlatform() const override
+    {
+        return TPolicy::Platform;
+    }
+
+    virtual void ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping) const override
+    {
+        TPolicy::ResolveMapping(Row, DisplayName, OutMapping);
+    }
+
+protected:
+    virtual bool IsWriteReady(IOnlineSubsystem& Subsystem) const override
+    {
+        return TPolicy::IsWriteReady(Subsystem);
+    }
+
+    virtual bool IsUserReady(const IOnlineIdentity& InIdentity, const FUniqueNetId& UserId) const override
+    {
+        return TPolicy::IsUserReady(InIdentity, UserId);
+    }
+};
+
+struct FSteamLeaderboardPolicy
+{
+    static constexpr ELeaderboardPlatform Platform = ELeaderboardPlatform::Steam;
+    static void ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping);
+    static bool IsWriteReady(IOnlineSubsystem& Subsystem) { return true; }
+    static bool IsUserReady(const IOnlineIdentity& Identity, const FUniqueNetId& UserId) { return true; }
+};
+
+struct FEpicLeaderboardPolicy
+{
+    static constexpr ELeaderboardPlatform Platform = ELeaderboardPlatform::Epic;
+    static void ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping);
+    // EOS only accepts leaderboard writes once its stats interface is up
+    static bool IsWriteReady(IOnlineSubsystem& Subsystem);
+    static bool IsUserReady(const IOnlineIdentity& Identity, const FUniqueNetId& UserId);
+};
+
+// Chosen only when there is neither a subsystem nor injected interfaces: boards resolve to their display names and every
+// read and write is refused. Resident rows, snapshots and the journal keep working, so offline builds behave like a
+// client that never got a reply; queued scores wait in the journal for a run with a backend.
+struct FNullLeaderboardPolicy
+{
+    static constexpr ELeaderboardPlatform Platform = ELeaderboardPlatform::Null;
+    static void ResolveMapping(const FLeaderboardPlatformMappingRow& Row, FName DisplayName, FLeaderboardMapping& OutMapping);
+    static bool IsWriteReady(IOnlineSubsystem& Subsystem) { return false; }
+    static bool IsUserReady(const IOnlineIdentity& Identity, const FUniqueNetId& UserId) { return true; }
+};
+
+typedef TLeaderboardBackend<FSteamLeaderboardPolicy> FSteamLeaderboardBackend;
+typedef TLeaderboardBackend<FEpicLeaderboardPolicy> FEpicLeaderboardBackend;
+typedef TLeaderboardBackend<FNullLeaderboardPolicy> FNullLeaderboardBackend;
@@ -1,396 +1,2639 @@
-#include "LeaderboardManager.h"
-#include "OnlineSubsystem.h"
-#include "OnlineStats.h"
-#include "Kismet/GameplayStatics.h"
-#include "Engine/World.h"
-
-void ULeaderboardManager::Initialize(UDataTable* InTable)
-{
-    LeaderboardMappingTable = InTable;
-    LeaderboardEntries.Empty();
-
-    IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
-    if (Subsystem)
-    {
-        FString SubsystemName = Subsystem->GetSubsystemName().ToString();
-        if (SubsystemName == "EOS" || SubsystemName == "Epic")
-        {
-            PlatformType = ELeaderboardPlatform::Epic;
-        }
-        else
-        {
-            PlatformType = ELeaderboardPlatform::Steam;
-        }
-    }
-}
-
-void ULeaderboardManager::WriteToLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score)
-{
-    switch (PlatformType)
-    {
-        case ELeaderboardPlatform::Steam:
-        {
-            WriteToSteamLeaderboard(WorldName, LeaderboardName, Score);
-            break;
-        }
-        case ELeaderboardPlatform::Epic:
-        {
-            WriteToEpicLeaderboard(WorldName, LeaderboardName, Score);
-            break;
-        }
-    }
-}
-
-void ULeaderboardManager::ReadLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
-{
-    switch (PlatformType)
-    {
-        case ELeaderboardPlatform::Steam:
-        {
-            ReadFromSteamLeaderboard(WorldName, LeaderboardName, bFriendsOnly, RankFirst, RankCount, DoNotShowWindow);
-            break;
-        }
-        case ELeaderboardPlatform::Epic:
-        {
-            ReadFromEpicLeaderboard(WorldName, LeaderboardName, bFriendsOnly, RankFirst, RankCount, DoNotShowWindow);
-            break;
-        }
-    }
-}
-
-const TMap<FString, TArray<FLeaderboardEntry>>& ULeaderboardManager::GetLeaderboardEntries() const
-{
-    return LeaderboardEntries;
-}
-
-const TArray<FLeaderboardEntry>& ULeaderboardManager::GetLeaderboardByName(const FString& LeaderboardName) const
-{
-    if (const TArray<FLeaderboardEntry>* Found = LeaderboardEntries.Find(LeaderboardName))
-    {
-        return *Found;
-    }
-
-    static const TArray<FLeaderboardEntry> EmptyArray;
-    return EmptyArray;
-}
-
-void ULeaderboardManager::OnLeaderboardReadComplete(bool bWasSuccessful, FOnlineLeaderboardReadRef LeaderboardReadRef)
-{
-    IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
-    if (Subsystem)
-    {
-        IOnlineLeaderboardsPtr Leaderboards = Subsystem->GetLeaderboardsInterface();
-        if (bWasSuccessful)
-        {
-            if (LeaderboardEntries.Contains(LeaderboardReadRef->LeaderboardName.ToString()))
-            {
-                LeaderboardEntries[LeaderboardReadRef->LeaderboardName.ToString()].Empty();
-            }
-            int32 MyRank = -1;
-            TSharedPtr<const FUniqueNetId> UserId;
-            IOnlineIdentityPtr Identity = Subsystem->GetIdentityInterface();
-            if (Identity.IsValid())
-            {
-                UserId = Identity->GetUniquePlayerId(0);
-            }
-            UE_LOG(LogTemp, Log, TEXT("Leaderboard data successfully read."));
-
-            for (const FOnlineStatsRow& Row : LeaderboardReadRef->Rows)
-            {
-                FString LocalPlayerName = Row.NickName;
-                int32 PlayerScore = 0;
-
-                const FVariantData* ScoreData = Row.Columns.Find(LeaderboardReadRef->SortedColumn);
-                if (ScoreData)
-                {
-                    ScoreData->GetValue(PlayerScore);
-                }
-                FLeaderboardEntry NewEntry;
-                NewEntry.PlayerName = LocalPlayerName;
-                NewEntry.Score = PlayerScore;
-                NewEntry.Rank = Row.Rank;
-                LeaderboardEntries.FindOrAdd(LeaderboardReadRef->LeaderboardName.ToString()).Add(NewEntry);
-                if (MyRank == -1 && UserId.IsValid() && Row.PlayerId == UserId)
-                {
-                    MyRank = Row.Rank;
-                }
-                UE_LOG(LogTemp, Log, TEXT("Player: %s, Score: %d"), *LocalPlayerName, PlayerScore);
-            }
-
-            if (LeaderboardEntries.Contains(LeaderboardReadRef->LeaderboardName.ToString()) && LeaderboardEntries[LeaderboardReadRef->LeaderboardName.ToString()].Num() > 1)
-            {
-                LeaderboardEntries[LeaderboardReadRef->LeaderboardName.ToString()].Sort([](const FLeaderboardEntry& A, const FLeaderboardEntry& B)
-                {
-                    return A.Rank < B.Rank;
-                });
-            }
-            
-            if (!bIsDoNotShowWindow)
-            {
-                OnLeaderboardWindowShow.Broadcast(bIsFriendLeaderboard);
-            }
-
-            OnLeaderBoardQueryCompleted.Broadcast(NAME_None, true);
-        }
-        else
-        {
-            if (LeaderboardEntries.Contains(LeaderboardReadRef->LeaderboardName.ToString()))
-            {
-                LeaderboardEntries[LeaderboardReadRef->LeaderboardName.ToString()].Empty();
-            }
-            if (!bIsDoNotShowWindow)
-            {
-                OnLeaderboardWindowShow.Broadcast(bIsFriendLeaderboard);
-            }
-            UE_LOG(LogTemp, Warning, TEXT("Failed to read leaderboard data."));
-            OnLeaderBoardQueryCompleted.Broadcast(NAME_None, false);
-        }
-        if (Leaderboards)
-        {
-            Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(QueryLeaderboardDelegateHandle);
-        }
-    }
-}
-
-void ULeaderboardManager::OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful)
-{
-    IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
-    if (Subsystem)
-    {
-        IOnlineLeaderboardsPtr Leaderboards = Subsystem->GetLeaderboardsInterface();
-        if (Leaderboards.IsValid())
-        {
-            Leaderboards->ClearOnLeaderboardFlushCompleteDelegate_Handle(FlushLeaderboardDelegateHandle);
-            FlushLeaderboardDelegateHandle.Reset();
-        }
-    }
-
-    UE_LOG(LogTemp, Log, TEXT("Leaderboard flush %s for session: %s"),
-        bWasSuccessful ? TEXT("succeeded") : TEXT("failed"),
-        *SessionName.ToString());
-
-    OnLeaderBoardFlushCompleted.Broadcast(SessionName, bWasSuccessful);
-}
-
-void ULeaderboardManager::GetMappedLeaderboardAndStat(const FString& DisplayName, FString& OutLeaderboardName, FString& OutStatName)
-{
-    if (!LeaderboardMappingTable) return;
-
-    const FLeaderboardPlatformMappingRow* Mapping = LeaderboardMappingTable->FindRow<FLeaderboardPlatformMappingRow>(*DisplayName, TEXT(""));
-    if (!Mapping) return;
-
-    switch (PlatformType)
-    {
-        case ELeaderboardPlatform::Steam:
-        {
-            OutLeaderboardName = Mapping->SteamLeaderboardName;
-            OutStatName = Mapping->SteamStatName;
-            break;
-
-        }
-        case ELeaderboardPlatform::Epic:
-        {
-            OutLeaderboardName = Mapping->EpicLeaderboardName;
-            OutStatName = Mapping->EpicStatName;
-            break;
-        }
-    }
-}
-
-// ===== Steam stuff =====
-
-void ULeaderboardManager::WriteToSteamLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score)
-{
-    IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
-    if (OnlineSub)
-    {
-        IOnlineIdentityPtr IdentityInterface = OnlineSub->GetIdentityInterface();
-        if (IdentityInterface.IsValid())
-        {
-            FUniqueNetIdPtr UserId = IdentityInterface->GetUniquePlayerId(0);
-            if (UserId.IsValid())
-            {
-                IOnlineLeaderboardsPtr Leaderboards = OnlineSub->GetLeaderboardsInterface();
-                if (Leaderboards.IsValid())
-                {
-                    FString LeaderboardAPIName, StatName;
-                    GetMappedLeaderboardAndStat(LeaderboardName, LeaderboardAPIName, StatName);
-                    FOnlineLeaderboardWrite WriteObject;
-                    WriteObject.LeaderboardNames.Add(FName(*LeaderboardName));
-                    WriteObject.RatedStat = FName(*LeaderboardAPIName);
-                    WriteObject.SortMethod = ELeaderboardSort::Descending;
-                    WriteObject.UpdateMethod = ELeaderboardUpdateMethod::KeepBest;
-                    WriteObject.SetIntStat(FName(*StatName), Score);
-
-                    if (Leaderboards->WriteLeaderboards(FName(WorldName), *UserId, WriteObject))
-                    {
-                        FlushLeaderboardDelegateHandle = Leaderboards->AddOnLeaderboardFlushCompleteDelegate_Handle(
-                            FOnLeaderboardFlushCompleteDelegate::CreateUObject(this, &ULeaderboardManager::OnLeaderboardFlushComplete));
-                        Leaderboards->FlushLeaderboards(FName(WorldName));
-                    }
-                }
-            }
-            else
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Failed to get UserId."));
-            }
-        }
-        else
-        {
-            UE_LOG(LogTemp, Warning, TEXT("IdentityInterface is not valid."));
-        }
-    }
-    else
-    {
-        UE_LOG(LogTemp, Warning, TEXT("OnlineSubsystem is not available."));
-    }
-}
-
-void ULeaderboardManager::ReadFromSteamLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
-{
-    if (IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
-    {
-        IOnlineIdentityPtr Identity = Subsystem->GetIdentityInterface();
-        if (Identity.IsValid())
-        {
-            FUniqueNetIdPtr NetId = Identity->GetUniquePlayerId(0);
-            if (!NetId)
-            {
-                return;
-            }
-        }
-
-        IOnlineLeaderboardsPtr Leaderboards = Subsystem->GetLeaderboardsInterface();
-        if (Leaderboards.IsValid())
-        {
-            FString LeaderboardAPIName, StatName;
-            GetMappedLeaderboardAndStat(LeaderboardName, LeaderboardAPIName, StatName);
-            bIsDoNotShowWindow = DoNotShowWindow;
-            FOnlineLeaderboardReadRef LeaderboardReadRef = MakeShared<FOnlineLeaderboardRead>();
-            LeaderboardReadRef->LeaderboardName = FName(*LeaderboardAPIName);
-            LeaderboardReadRef->SortedColumn = FName(*StatName);
-            FColumnMetaData ColumnMetaData = FColumnMetaData(FName(*StatName), EOnlineKeyValuePairDataType::Int32);
-            LeaderboardReadRef->ColumnMetadata.Add(ColumnMetaData);
-            LeaderboardReadRef->Rows.Empty();
-
-            QueryLeaderboardDelegateHandle =
-                Leaderboards->AddOnLeaderboardReadCompleteDelegate_Handle(FOnLeaderboardReadCompleteDelegate::CreateUObject(
-                    this,
-                    &ULeaderboardManager::OnLeaderboardReadComplete, LeaderboardReadRef));
-
-            bIsFriendLeaderboard = bFriendsOnly;
-            if (bFriendsOnly)
-            {
-                if (!Leaderboards->ReadLeaderboardsForFriends(0, LeaderboardReadRef))
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to read friends leaderboard."));
-                    Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(QueryLeaderboardDelegateHandle);
-                    QueryLeaderboardDelegateHandle.Reset();
-                }
-            }
-            else
-            {
-                if (!Leaderboards->ReadLeaderboardsAroundRank(RankFirst, RankCount, LeaderboardReadRef))
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to read global leaderboard."));
-                    Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(QueryLeaderboardDelegateHandle);
-                    QueryLeaderboardDelegateHandle.Reset();
-                }
-            }
-        }
-    }
-}
-
-// ===== Epic stuff =====
-
-void ULeaderboardManager::WriteToEpicLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score)
-{
-    if (IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
-    {
-        IOnlineStatsPtr StatsInterface = Subsystem->GetStatsInterface();
-        if (StatsInterface.IsValid())
-        {
-            IOnlineIdentityPtr Identity = Subsystem->GetIdentityInterface();
-            if (Identity.IsValid())
-            {
-                FUniqueNetIdPtr UserId = Identity->GetUniquePlayerId(0);
-                if (UserId.IsValid())
-                {
-                    IOnlineLeaderboardsPtr Leaderboards = Subsystem->GetLeaderboardsInterface();
-                    if (Leaderboards.IsValid())
-                    {
-                        FString LeaderboardAPIName, StatName;
-                        GetMappedLeaderboardAndStat(LeaderboardName, LeaderboardAPIName, StatName);
-                        FOnlineLeaderboardWrite WriteObject;
-                        WriteObject.LeaderboardNames.Add(FName(*LeaderboardAPIName));
-                        WriteObject.RatedStat = FName(*StatName);
-                        WriteObject.SortMethod = ELeaderboardSort::Descending;
-                        WriteObject.UpdateMethod = ELeaderboardUpdateMethod::KeepBest;
-                        WriteObject.SetIntStat(FName(*StatName), Score);
-
-                        if (Leaderboards->WriteLeaderboards(FName(WorldName), *UserId, WriteObject))
-                        {
-                            FlushLeaderboardDelegateHandle = Leaderboards->AddOnLeaderboardFlushCompleteDelegate_Handle(
-                                FOnLeaderboardFlushCompleteDelegate::CreateUObject(this, &ULeaderboardManager::OnLeaderboardFlushComplete));
-                            Leaderboards->FlushLeaderboards(FName(WorldName));
-                        }
-                    }
-                }
-            }
-        }
-    }
-}
-
-void ULeaderboardManager::ReadFromEpicLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
-{
-    IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
-    if (Subsystem)
-    {
-        IOnlineIdentityPtr Identity = Subsystem->GetIdentityInterface();
-        if (Identity.IsValid())
-        {
-            FUniqueNetIdPtr NetId = Identity->GetUniquePlayerId(0);
-            if (!NetId || Identity->GetLoginStatus(*NetId) != ELoginStatus::LoggedIn)
-            {
-                return;
-            }
-        }
-
-        IOnlineLeaderboardsPtr Leaderboards = Subsystem->GetLeaderboardsInterface();
-        if (Leaderboards.IsValid())
-        {
-            FString LeaderboardAPIName, StatName;
-            GetMappedLeaderboardAndStat(LeaderboardName, LeaderboardAPIName, StatName);
-            bIsDoNotShowWindow = DoNotShowWindow;
-            FOnlineLeaderboardReadRef LeaderboardReadRef = MakeShared<FOnlineLeaderboardRead, ESPMode::ThreadSafe>();
-            LeaderboardReadRef->LeaderboardName = FName(*LeaderboardAPIName);
-            LeaderboardReadRef->SortedColumn = FName(*StatName);
-            FColumnMetaData ColumnMetaData = FColumnMetaData(FName(*StatName), EOnlineKeyValuePairDataType::Int32);
-            LeaderboardReadRef->ColumnMetadata.Add(ColumnMetaData);
-            QueryLeaderboardDelegateHandle =
-                Leaderboards->AddOnLeaderboardReadCompleteDelegate_Handle(FOnLeaderboardReadCompleteDelegate::CreateUObject(
-                    this,
-                    &ULeaderboardManager::OnLeaderboardReadComplete, LeaderboardReadRef));
-
-            bIsFriendLeaderboard = bFriendsOnly;
-            if (bFriendsOnly)
-            {
-                if (!Leaderboards->ReadLeaderboardsForFriends(0, LeaderboardReadRef))
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to read friends leaderboard."));
-                    Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(QueryLeaderboardDelegateHandle);
-                    QueryLeaderboardDelegateHandle.Reset();
-                }
-            }
-            else
-            {
-                if (!Leaderboards->ReadLeaderboardsAroundRank(RankFirst, RankCount, LeaderboardReadRef))
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Failed to read global leaderboard."));
-                    Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(QueryLeaderboardDelegateHandle);
-                    QueryLeaderboardDelegateHandle.Reset();
-                }
-            }
-        }
-    }
-}
+#include "LeaderboardManager.h"
+#include "OnlineSubsystem.h"
+#include "OnlineStats.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/DataTable.h"
+#include "Async/Async.h"
+#include "Algo/StableSort.h"
+#include "LeaderboardSnapshot.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_LOG_CATEGORY(LogLeaderboard);
+
+DECLARE_STATS_GROUP(TEXT("Leaderboard"), STATGROUP_Leaderboard, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Write"), STAT_LeaderboardWrite, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Read"), STAT_LeaderboardRead, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Read Complete"), STAT_LeaderboardReadComplete, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Parse Rows"), STAT_LeaderboardParseRows, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Merge Rows"), STAT_LeaderboardMergeRows, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Flush Writes"), STAT_LeaderboardFlushWrites, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Flush Complete"), STAT_LeaderboardFlushComplete, STATGROUP_Leaderboard);
+DECLARE_CYCLE_STAT(TEXT("Save Snapshot"), STAT_LeaderboardSaveSnapshot, STATGROUP_Leaderboard);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Hits"), STAT_LeaderboardCacheHits, STATGROUP_Leaderboard);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rows Parsed"), STAT_LeaderboardRowsParsed, STATGROUP_Leaderboard);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("In-Flight Reads"), STAT_LeaderboardInFlightReads, STATGROUP_Leaderboard);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Writes"), STAT_LeaderboardPendingWrites, STATGROUP_Leaderboard);
+DECLARE_MEMORY_STAT(TEXT("Entry Views"), STAT_LeaderboardEntryViewMemory, STATGROUP_Leaderboard);
+
+TRACE_DECLARE_INT_COUNTER(LeaderboardInFlightReads, TEXT("Leaderboard/InFlightReads"));
+TRACE_DECLARE_INT_COUNTER(LeaderboardPendingWrites, TEXT("Leaderboard/PendingWrites"));
+
+// Logs every parsed row. Off by default since a large read would log thousands of lines in one frame.
+#ifndef LEADERBOARD_LOG_ROWS
+#define LEADERBOARD_LOG_ROWS 0
+#endif
+
+namespace
+{
+    // Below this many interned strings the name table is never worth compacting
+    const int32 NameTableCompactMinimum = 4096;
+
+    // One backend write: a single player's stats on a single board
+    struct FLeaderboardPlayerWrite
+    {
+        FUniqueNetIdPtr UserId;
+        FOnlineLeaderboardWrite Write;
+    };
+
+    // Safe to run on any thread: reads nothing but the finished read object
+    void ParseLeaderboardRows(const FOnlineLeaderboardRead& Read, const FString& LocalPlayerId, FLeaderboardParsedRead& OutParsed)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(LeaderboardParseRows);
+        SCOPE_CYCLE_COUNTER(STAT_LeaderboardParseRows);
+        const double StartTime = FPlatformTime::Seconds();
+
+        OutParsed.Rows.Reset(Read.Rows.Num());
+        OutParsed.LocalRowIndex = INDEX_NONE;
+
+        for (const FOnlineStatsRow& Row : Read.Rows)
+        {
+            FLeaderboardParsedRow& Parsed = OutParsed.Rows.AddDefaulted_GetRef();
+            if (const FVariantData* ScoreData = Row.Columns.Find(Read.SortedColumn))
+            {
+                ScoreData->GetValue(Parsed.Score);
+            }
+            Parsed.Rank = Row.Rank;
+            Parsed.PlayerName = Row.NickName;
+            Parsed.PlayerId = Row.PlayerId.IsValid() ? Row.PlayerId->ToString() : FString::Printf(TEXT("#%d"), Row.Rank);
+            Parsed.PlayerNameHash = GetTypeHash(Parsed.PlayerName);
+            Parsed.PlayerIdHash = GetTypeHash(Parsed.PlayerId);
+        }
+
+        // Backends don't promise an order
+        Algo::StableSortBy(OutParsed.Rows, &FLeaderboardParsedRow::Rank);
+
+        if (!LocalPlayerId.IsEmpty())
+        {
+            OutParsed.LocalRowIndex = OutParsed.Rows.IndexOfByPredicate([&LocalPlayerId](const FLeaderboardParsedRow& Parsed)
+            {
+                return Parsed.PlayerId.Equals(LocalPlayerId, ESearchCase::CaseSensitive);
+            });
+        }
+        OutParsed.ParseSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+
+    // Leaderboard.Stats [reset]
+    FAutoConsoleCommand LeaderboardStatsCommand(
+        TEXT("Leaderboard.Stats"),
+        TEXT("Prints the metrics of every leaderboard manager. Pass 'reset' to clear the counters afterwards."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const bool bReset = Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+            for (TObjectIterator<ULeaderboardManager> It; It; ++It)
+            {
+                if (It->HasAnyFlags(RF_ClassDefaultObject))
+                {
+                    continue;
+                }
+                UE_LOG(LogLeaderboard, Display, TEXT("%s\n%s"), *It->GetPathName(), *It->GetMetrics().ToString());
+                if (bReset)
+                {
+                    It->ResetMetrics();
+                }
+            }
+        }));
+}
+
+void ULeaderboardManager::Initialize(UDataTable* InTable)
+{
+#if WITH_EDITOR
+    if (LeaderboardMappingTable && MappingTableChangedHandle.IsValid())
+    {
+        LeaderboardMappingTable->OnDataTableChanged().Remove(MappingTableChangedHandle);
+        MappingTableChangedHandle.Reset();
+    }
+#endif
+
+    LeaderboardMappingTable = InTable;
+    Metrics = FLeaderboardMetrics();
+    LeaderboardEntries.Empty();
+    Boards.Empty();
+    NameTable.Reset();
+    QueryCache.Empty();
+    SubmitStates.Empty();
+    NumHeldScores = 0;
+
+    IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
+    Backend = FLeaderboardBackend::Create(Subsystem, LeaderboardsOverride.IsValid());
+    Backend->Bind(Subsystem, LeaderboardsOverride, IdentityOverride);
+    PlatformType = Backend->GetPlatform();
+
+    CompiledMappings.Empty();
+    MappingHandleByName.Empty();
+    CompileMappingTable();
+#if WITH_EDITOR
+    if (LeaderboardMappingTable)
+    {
+        MappingTableChangedHandle = LeaderboardMappingTable->OnDataTableChanged().AddUObject(this, &ULeaderboardManager::CompileMappingTable);
+    }
+#endif
+
+    if (bJournalWrites && !WriteJournal.IsOpen())
+    {
+        WriteJournal.Open(GetJournalPath(), JournalReplay);
+    }
+
+    bSnapshotDirty = false;
+    SnapshotRefreshRanges.Empty();
+    if (bPersistSnapshot)
+    {
+        LoadLeaderboardSnapshot();
+        LastSnapshotSaveTime = FPlatformTime::Seconds();
+    }
+
+    if (!WriteQueueTickerHandle.IsValid())
+    {
+        LastWriteFlushTime = FPlatformTime::Seconds();
+        WriteQueueTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &ULeaderboardManager::TickWriteQueue));
+    }
+}
+
+void ULeaderboardManager::BeginDestroy()
+{
+    if (WriteQueueTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(WriteQueueTickerHandle);
+        WriteQueueTickerHandle.Reset();
+    }
+
+    // Don't lose scores that were still waiting for the next interval
+    FlushPendingWrites();
+    WriteJournal.Close();
+
+    if (SnapshotWriteTask.IsValid())
+    {
+        SnapshotWriteTask.Wait();
+    }
+    if (bSnapshotDirty && bPersistSnapshot)
+    {
+        SaveLeaderboardSnapshot();
+        if (SnapshotWriteTask.IsValid())
+        {
+            SnapshotWriteTask.Wait();
+        }
+    }
+
+#if WITH_EDITOR
+    if (LeaderboardMappingTable && MappingTableChangedHandle.IsValid())
+    {
+        LeaderboardMappingTable->OnDataTableChanged().Remove(MappingTableChangedHandle);
+        MappingTableChangedHandle.Reset();
+    }
+#endif
+
+    IOnlineLeaderboardsPtr Leaderboards = GetLeaderboardsInterface();
+    if (Leaderboards.IsValid())
+    {
+        Leaderboards->ClearOnLeaderboardFlushCompleteDelegate_Handle(FlushLeaderboardDelegateHandle);
+        FlushLeaderboardDelegateHandle.Reset();
+        for (TPair<int32, FLeaderboardReadRequest>& Pending : InFlightReads)
+        {
+            Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(Pending.Value.DelegateHandle);
+        }
+    }
+    WritesAwaitingFlush.Empty();
+    FlushStartTimes.Empty();
+    Subscriptions.Empty();
+    SubscriptionByRequest.Empty();
+    InFlightReads.Empty();
+    ReadBatches.Empty();
+    BatchSlotByRequest.Empty();
+    InFlightQueries.Empty();
+    Backend.Reset();
+
+    Super::BeginDestroy();
+}
+
+void ULeaderboardManager::WriteToLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score)
+{
+    const int32 LeaderboardHandle = FindLeaderboardHandle(LeaderboardName);
+    if (LeaderboardHandle == INDEX_NONE)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return;
+    }
+    WriteToLeaderboardByHandle(WorldName, LeaderboardHandle, Score);
+}
+
+void ULeaderboardManager::WriteToLeaderboardByHandle(const FString& WorldName, int32 LeaderboardHandle, int32 Score)
+{
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(LeaderboardHandle);
+    if (!Mapping)
+    {
+        return;
+    }
+    WriteScore(WorldName, *Mapping, GetLocalUserId(0), 0, Score);
+}
+
+void ULeaderboardManager::WriteToLeaderboardForUser(const FString& WorldName, const FString& LeaderboardName, int32 LocalUserNum, int32 Score)
+{
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(LeaderboardName));
+    if (!Mapping)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return;
+    }
+    WriteScore(WorldName, *Mapping, GetLocalUserId(LocalUserNum), LocalUserNum, Score);
+}
+
+void ULeaderboardManager::WriteToLeaderboardForPlayer(const FString& WorldName, const FString& LeaderboardName, const FUniqueNetIdRepl& PlayerId, int32 Score)
+{
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(LeaderboardName));
+    if (!Mapping)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return;
+    }
+    WriteScore(WorldName, *Mapping, PlayerId.GetUniqueNetId(), INDEX_NONE, Score);
+}
+
+void ULeaderboardManager::WriteLeaderboardScores(const FString& WorldName, const FString& LeaderboardName, const TArray<FLeaderboardPlayerScore>& Scores)
+{
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(LeaderboardName));
+    if (!Mapping)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return;
+    }
+
+    {
+        // Queue the whole match first; a threshold flush halfway would leave the rest waiting for the next one
+        TGuardValue<bool> QueueingBatch(bQueueingWriteBatch, true);
+        for (const FLeaderboardPlayerScore& PlayerScore : Scores)
+        {
+            WriteScore(WorldName, *Mapping, PlayerScore.PlayerId.GetUniqueNetId(), INDEX_NONE, PlayerScore.Score);
+        }
+    }
+
+    if (PendingWrites.Num() > 0)
+    {
+        FlushPendingWrites();
+    }
+}
+
+void ULeaderboardManager::WriteScore(const FString& WorldName, const FLeaderboardMapping& Mapping, FUniqueNetIdPtr UserId, int32 LocalUserNum, int32 Score)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::WriteToLeaderboard);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardWrite);
+
+    if (!UserId.IsValid())
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("Failed to get UserId."));
+        return;
+    }
+
+    const FString PlayerId = UserId->ToString();
+    const double Now = FPlatformTime::Seconds();
+    if (!PassesScoreGate(WorldName, Mapping, UserId, PlayerId, LocalUserNum, Score, Now))
+    {
+        return;
+    }
+
+    InvalidateCachedQueries(Mapping.DisplayName);
+
+    // Queued and journaled even while the backend refuses writes, the flush sends it once it accepts them
+    EnqueueWrite(FName(WorldName), UserId, Mapping.WriteLeaderboardName, Mapping.RatedStat, Mapping.StatName, Score);
+
+    FLeaderboardSubmitState& State = SubmitStates.FindOrAdd(Mapping.DisplayName).FindOrAdd(PlayerId);
+    State.BestScore = FMath::Max(State.BestScore, Score);
+    State.LastWriteTime = Now;
+
+    if (LocalUserNum == INDEX_NONE)
+    {
+        return;
+    }
+
+    // Remember the score until a read returns it so the UI can show where it lands straight away
+    FLeaderboardBoard* Board = Boards.Find(Mapping.DisplayName);
+    if (!Board)
+    {
+        Board = &Boards.Add(Mapping.DisplayName, FLeaderboardBoard(LeaderboardPageSize));
+    }
+    FLeaderboardUserState& User = Board->GetUser(LocalUserNum);
+    if (Score > User.ProvisionalScore)
+    {
+        User.ProvisionalScore = Score;
+        FLeaderboardRankProjection Projection;
+        ProjectLocalRank(*Board, LocalUserNum, Score, 0, Projection);
+        User.ProvisionalRank = Projection.Rank;
+    }
+    if (User.bFriendsLoaded)
+    {
+        UpdateLocalFriendScore(*Board, LocalUserNum, Score);
+    }
+}
+
+bool ULeaderboardManager::PassesScoreGate(const FString& WorldName, const FLeaderboardMapping& Mapping, FUniqueNetIdPtr UserId, const FString& PlayerId, int32 LocalUserNum, int32 Score, double Now)
+{
+    const FLeaderboardScoreGate& Gate = Mapping.ScoreGate;
+    if (Gate.bLimitScore && (Score < Gate.MinScore || Score > Gate.MaxScore))
+    {
+        ++Metrics.WritesRejectedOutOfRange;
+        UE_LOG(LogLeaderboard, Warning, TEXT("Rejected %s score %d, outside [%d, %d]."), *Mapping.DisplayName.ToString(), Score, Gate.MinScore, Gate.MaxScore);
+        return false;
+    }
+
+    TMap<FString, FLeaderboardSubmitState>* PlayerStates = SubmitStates.Find(Mapping.DisplayName);
+    FLeaderboardSubmitState* State = PlayerStates ? PlayerStates->Find(PlayerId) : nullptr;
+
+    if (Gate.bDropNonImprovingScores)
+    {
+        // The best this client queued or is holding back, or the best the backend reported in any resident row
+        int32 KnownBest = State ? FMath::Max(State->BestScore, State->HeldScore) : MIN_int32;
+        const FLeaderboardBoard* Board = Boards.Find(Mapping.DisplayName);
+        const int32 PlayerHandle = Board ? NameTable.Find(PlayerId) : INDEX_NONE;
+        if (PlayerHandle != INDEX_NONE)
+        {
+            if (const FLeaderboardRow* Row = Board->RankIndex.FindPlayer(PlayerHandle))
+            {
+                KnownBest = FMath::Max(KnownBest, Row->Score);
+            }
+            if (const FLeaderboardRow* Row = Board->PlayersIndex.FindPlayer(PlayerHandle))
+            {
+                KnownBest = FMath::Max(KnownBest, Row->Score);
+            }
+        }
+        if (KnownBest != MIN_int32 && Score <= KnownBest)
+        {
+            ++Metrics.WritesRejectedNotImproving;
+            UE_LOG(LogLeaderboard, Verbose, TEXT("Dropped %s score %d, best known is %d."), *Mapping.DisplayName.ToString(), Score, KnownBest);
+            return false;
+        }
+    }
+
+    if (Gate.MinWriteInterval > 0.0f && State && Now - State->LastWriteTime < Gate.MinWriteInterval)
+    {
+        // Boards keep the best, so holding the best score of the interval loses nothing
+        ++Metrics.WritesThrottled;
+        if (State->HeldScore == MIN_int32)
+        {
+            ++NumHeldScores;
+        }
+        if (State->HeldScore == MIN_int32 || Score > State->HeldScore)
+        {
+            State->HeldScore = Score;
+            State->HeldWorldName = WorldName;
+            State->HeldUserId = UserId;
+            State->HeldLocalUserNum = LocalUserNum;
+        }
+        UE_LOG(LogLeaderboard, Verbose, TEXT("Holding %s score %d, last one was %.1f seconds ago."), *Mapping.DisplayName.ToString(), Score, Now - State->LastWriteTime);
+        return false;
+    }
+    return true;
+}
+
+void ULeaderboardManager::ReleaseHeldScores(double Now)
+{
+    struct FReleasedScore
+    {
+        FName DisplayName;
+        FString WorldName;
+        FUniqueNetIdPtr UserId;
+        int32 LocalUserNum;
+        int32 Score;
+    };
+    TArray<FReleasedScore> Released;
+    for (TPair<FName, TMap<FString, FLeaderboardSubmitState>>& Board : SubmitStates)
+    {
+        const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(Board.Key.ToString()));
+        const float Interval = Mapping ? Mapping->ScoreGate.MinWriteInterval : 0.0f;
+        for (TPair<FString, FLeaderboardSubmitState>& Player : Board.Value)
+        {
+            FLeaderboardSubmitState& State = Player.Value;
+            if (State.HeldScore != MIN_int32 && Now - State.LastWriteTime >= Interval)
+            {
+                Released.Add({ Board.Key, MoveTemp(State.HeldWorldName), MoveTemp(State.HeldUserId), State.HeldLocalUserNum, State.HeldScore });
+                State.HeldScore = MIN_int32;
+                --NumHeldScores;
+            }
+        }
+    }
+
+    // Written after the walk, WriteScore adds to SubmitStates
+    for (const FReleasedScore& Score : Released)
+    {
+        if (const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(Score.DisplayName.ToString())))
+        {
+            WriteScore(Score.WorldName, *Mapping, Score.UserId, Score.LocalUserNum, Score.Score);
+        }
+    }
+}
+
+int32 ULeaderboardManager::ReadLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
+{
+    const int32 LeaderboardHandle = FindLeaderboardHandle(LeaderboardName);
+    if (LeaderboardHandle == INDEX_NONE)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return INDEX_NONE;
+    }
+    return ReadLeaderboardByHandle(WorldName, LeaderboardHandle, bFriendsOnly, RankFirst, RankCount, DoNotShowWindow);
+}
+
+int32 ULeaderboardManager::ReadLeaderboardForUser(const FString& WorldName, const FString& LeaderboardName, int32 LocalUserNum, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
+{
+    const int32 LeaderboardHandle = FindLeaderboardHandle(LeaderboardName);
+    if (LeaderboardHandle == INDEX_NONE)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return INDEX_NONE;
+    }
+    return ReadLeaderboardByHandle(WorldName, LeaderboardHandle, bFriendsOnly, RankFirst, RankCount, DoNotShowWindow, LocalUserNum);
+}
+
+int32 ULeaderboardManager::ReadLeaderboardForPlayers(const FString& WorldName, const FString& LeaderboardName, const TArray<FUniqueNetIdRepl>& Players, bool DoNotShowWindow)
+{
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(LeaderboardName));
+    if (!Mapping)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("No leaderboard mapping for %s."), *LeaderboardName);
+        return INDEX_NONE;
+    }
+
+    FLeaderboardReadTarget Target;
+    Target.Players.Reserve(Players.Num());
+    for (const FUniqueNetIdRepl& Player : Players)
+    {
+        if (Player.IsValid())
+        {
+            Target.Players.Add(Player.GetUniqueNetId().ToSharedRef());
+        }
+    }
+    if (Target.Players.Num() == 0)
+    {
+        return INDEX_NONE;
+    }
+    ++Metrics.CacheMisses;
+    return IssueLeaderboardRead(WorldName, *Mapping, Target, DoNotShowWindow);
+}
+
+int32 ULeaderboardManager::ReadLeaderboardByHandle(const FString& WorldName, int32 LeaderboardHandle, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow, int32 LocalUserNum)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::ReadLeaderboard);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardRead);
+
+    const FLeaderboardMapping* Mapping = GetLeaderboardMapping(LeaderboardHandle);
+    if (!Mapping)
+    {
+        return INDEX_NONE;
+    }
+
+    FLeaderboardQueryKey Key;
+    Key.LeaderboardName = Mapping->DisplayName;
+    Key.bFriendsOnly = bFriendsOnly;
+    Key.RankFirst = RankFirst;
+    Key.RankCount = RankCount;
+    Key.LocalUserNum = bFriendsOnly ? LocalUserNum : 0;
+
+    FLeaderboardReadTarget Target;
+    Target.LocalUserNum = LocalUserNum;
+    Target.bFriendsOnly = bFriendsOnly;
+    Target.RankFirst = RankFirst;
+    Target.RankCount = RankCount;
+
+    // Scheduled refreshes exist to reach the backend, an answer from memory would only back them off
+    if (bFriendsOnly && FriendsIndexLifetime > 0.0f && !bIssuingRefresh)
+    {
+        FLeaderboardBoard* Board = Boards.Find(Mapping->DisplayName);
+        const FLeaderboardUserState* User = Board ? Board->FindUser(LocalUserNum) : nullptr;
+        if (User && User->bFriendsLoaded && FPlatformTime::Seconds() - User->FriendsFetchTime <= FriendsIndexLifetime)
+        {
+            ++Metrics.CacheHits;
+            INC_DWORD_STAT(STAT_LeaderboardCacheHits);
+            return ServeFriendsIndex(*Mapping, *Board, LocalUserNum, DoNotShowWindow);
+        }
+    }
+
+    if (QueryCacheTTL > 0.0f && !bIssuingRefresh)
+    {
+        if (const FLeaderboardCachedQuery* Cached = QueryCache.Find(Key))
+        {
+            const double Age = FPlatformTime::Seconds() - Cached->FetchTime;
+            if (Age <= QueryCacheTTL)
+            {
+                const int32 RequestId = ServeCachedQuery(*Cached, Key, DoNotShowWindow);
+                if (RequestId != INDEX_NONE)
+                {
+                    ++Metrics.CacheHits;
+                    INC_DWORD_STAT(STAT_LeaderboardCacheHits);
+                    return RequestId;
+                }
+            }
+            else if (Age <= QueryCacheTTL + QueryCacheStaleLifetime)
+            {
+                // Stale-while-revalidate: answer now, refresh silently unless a refresh is already running
+                const FLeaderboardCachedQuery StaleCopy = *Cached;
+                if (!InFlightQueries.Contains(Key))
+                {
+                    IssueLeaderboardRead(WorldName, *Mapping, Target, true);
+                }
+                const int32 RequestId = ServeCachedQuery(StaleCopy, Key, DoNotShowWindow);
+                if (RequestId != INDEX_NONE)
+                {
+                    ++Metrics.CacheStaleHits;
+                    INC_DWORD_STAT(STAT_LeaderboardCacheHits);
+                    return RequestId;
+                }
+            }
+            QueryCache.Remove(Key);
+        }
+    }
+    ++Metrics.CacheMisses;
+
+    // Identical query already on the wire, piggyback on its completion instead of issuing another
+    if (const int32* PrimaryId = InFlightQueries.Find(Key))
+    {
+        if (FLeaderboardReadRequest* Primary = InFlightReads.Find(*PrimaryId))
+        {
+            FLeaderboardReadWaiter& Waiter = Primary->Waiters.AddDefaulted_GetRef();
+            Waiter.RequestId = NextReadRequestId++;
+            Waiter.bDoNotShowWindow = DoNotShowWindow;
+            ++Metrics.ReadsDeduplicated;
+            return Waiter.RequestId;
+        }
+        InFlightQueries.Remove(Key);
+    }
+
+    return IssueLeaderboardRead(WorldName, *Mapping, Target, DoNotShowWindow);
+}
+
+int32 ULeaderboardManager::IssueLeaderboardRead(const FString& WorldName, const FLeaderboardMapping& Mapping, const FLeaderboardReadTarget& Target, bool DoNotShowWindow)
+{
+    if (!Backend.IsValid() || !Backend->CanRead(Target.LocalUserNum, Target.Players.Num() == 0))
+    {
+        return INDEX_NONE;
+    }
+
+    FOnlineLeaderboardReadRef LeaderboardReadRef = MakeShared<FOnlineLeaderboardRead, ESPMode::ThreadSafe>();
+    LeaderboardReadRef->LeaderboardName = Mapping.LeaderboardName;
+    LeaderboardReadRef->SortedColumn = Mapping.StatName;
+    LeaderboardReadRef->ColumnMetadata.Add(Mapping.ColumnMetaData);
+
+    return StartLeaderboardRead(Backend->GetLeaderboards(), Mapping.DisplayName, LeaderboardReadRef, Target, DoNotShowWindow);
+}
+
+int32 ULeaderboardManager::ServeFriendsIndex(const FLeaderboardMapping& Mapping, FLeaderboardBoard& Board, int32 LocalUserNum, bool DoNotShowWindow)
+{
+    const int32 RequestId = NextReadRequestId++;
+    ShowBoardView(Mapping.DisplayName, Board, true, LocalUserNum);
+
+    if (!DoNotShowWindow)
+    {
+        OnLeaderboardWindowShow.Broadcast(true);
+    }
+    BroadcastQueryCompleted(Mapping.DisplayName, RequestId, true);
+    return RequestId;
+}
+
+void ULeaderboardManager::UpdateLocalFriendScore(FLeaderboardBoard& Board, int32 LocalUserNum, int32 Score)
+{
+    const FString LocalId = GetLocalPlayerId(LocalUserNum);
+    if (LocalId.IsEmpty())
+    {
+        return;
+    }
+
+    FLeaderboardRankIndex& FriendsIndex = Board.GetUser(LocalUserNum).FriendsIndex;
+    const int32 LocalHandle = NameTable.Intern(LocalId);
+    const FLeaderboardRow* Existing = FriendsIndex.FindPlayer(LocalHandle);
+    if (Existing && Existing->Score >= Score)
+    {
+        return;
+    }
+
+    FLeaderboardRankProjection Projection;
+    ProjectLocalRank(Board, LocalUserNum, Score, 0, Projection);
+
+    FLeaderboardRow LocalRow;
+    LocalRow.Score = Score;
+    LocalRow.Rank = Projection.Rank;
+    LocalRow.PlayerHandle = LocalHandle;
+    if (Existing)
+    {
+        LocalRow.NameHandle = Existing->NameHandle;
+    }
+    else
+    {
+        IOnlineIdentityPtr Identity = GetIdentityInterface();
+        LocalRow.NameHandle = NameTable.Intern(Identity.IsValid() ? Identity->GetPlayerNickname(LocalUserNum) : LocalId);
+    }
+    const int32 OldRank = Existing && Existing->Rank > 0 ? Existing->Rank : MAX_int32;
+
+    // Friends passed on the way up drop one global rank, the same shift the projection applies to its neighbours
+    TArray<FLeaderboardRow> Rows;
+    FriendsIndex.ToArray(Rows);
+    FriendsIndex.Reset();
+    FriendsIndex.Reserve(Rows.Num() + 1);
+    for (FLeaderboardRow& Row : Rows)
+    {
+        if (Row.PlayerHandle == LocalHandle)
+        {
+            continue;
+        }
+        if (LocalRow.Rank > 0 && Row.Score < Score && Row.Rank >= LocalRow.Rank && Row.Rank < OldRank)
+        {
+            ++Row.Rank;
+        }
+        FriendsIndex.Upsert(Row);
+    }
+    FriendsIndex.Upsert(LocalRow);
+    if (Board.bShowingFriends && Board.ViewUserNum == LocalUserNum)
+    {
+        Board.bViewDirty = true;
+    }
+}
+
+void ULeaderboardManager::ShowBoardView(FName LeaderboardName, FLeaderboardBoard& Board, bool bFriendsOnly, int32 LocalUserNum)
+{
+    if (bFriendsOnly ? (Board.bShowingFriends && Board.ViewUserNum == LocalUserNum) : !Board.bShowingFriends)
+    {
+        return;
+    }
+
+    TArray<FLeaderboardRow> OldRows;
+    if (OnLeaderboardRowsChanged.IsBound())
+    {
+        Board.GetViewIndex().ToArray(OldRows);
+    }
+    Board.bShowingFriends = bFriendsOnly;
+    Board.ViewUserNum = bFriendsOnly ? LocalUserNum : Board.ViewUserNum;
+    Board.bViewDirty = true;
+
+    if (OnLeaderboardRowsChanged.IsBound())
+    {
+        TArray<FLeaderboardRow> NewRows;
+        Board.GetViewIndex().ToArray(NewRows);
+        FLeaderboardChangeSet Changes;
+        DiffRows(OldRows, NewRows, Changes);
+        if (!Changes.IsEmpty())
+        {
+            OnLeaderboardRowsChanged.Broadcast(LeaderboardName, Changes);
+        }
+    }
+}
+
+int32 ULeaderboardManager::ServeCachedQuery(const FLeaderboardCachedQuery& Cached, const FLeaderboardQueryKey& Key, bool DoNotShowWindow)
+{
+    FLeaderboardBoard* Board = Boards.Find(Cached.BoardKey);
+    bool bStoreIsCurrent = false;
+    if (Key.bFriendsOnly)
+    {
+        // Local writes keep the friends index ahead of any cached copy of it
+        const FLeaderboardUserState* User = Board ? Board->FindUser(Key.LocalUserNum) : nullptr;
+        bStoreIsCurrent = User && User->bFriendsLoaded;
+    }
+    else if (Board)
+    {
+        bStoreIsCurrent = Board->LastMergeTime >= Cached.FetchTime && Board->Store.IsRangeResident(Key.RankFirst, Key.RankCount);
+        // A newer read merged over part of the window and the rest was evicted; the cached rows would roll it back
+        if (!bStoreIsCurrent && Board->LastMergeTime > Cached.FetchTime)
+        {
+            return INDEX_NONE;
+        }
+    }
+
+    const int32 RequestId = NextReadRequestId++;
+    if (bStoreIsCurrent)
+    {
+        // The store already holds this window at least as fresh as the cached copy, so it is only shown
+        ShowBoardView(Key.LeaderboardName, *Board, Key.bFriendsOnly, Key.LocalUserNum);
+        if (!Key.bFriendsOnly)
+        {
+            Board->Store.Touch(Key.RankFirst, Key.RankCount);
+        }
+    }
+    else
+    {
+        // Nothing newer reached the board since, the cached rows only put evicted pages back
+        FLeaderboardChangeSet Changes;
+        ApplyReadRows(Cached.BoardKey, Key.bFriendsOnly, Key.RankFirst, Key.RankCount, Cached.Rows, OnLeaderboardRowsChanged.IsBound() ? &Changes : nullptr, Key.LocalUserNum);
+        if (!Changes.IsEmpty())
+        {
+            OnLeaderboardRowsChanged.Broadcast(Key.LeaderboardName, Changes);
+        }
+    }
+
+    if (!DoNotShowWindow)
+    {
+        OnLeaderboardWindowShow.Broadcast(Key.bFriendsOnly);
+    }
+    BroadcastQueryCompleted(Key.LeaderboardName, RequestId, true);
+    return RequestId;
+}
+
+void ULeaderboardManager::ApplyReadRows(FName BoardKey, bool bFriendsOnly, int32 RankFirst, int32 RankCount, const TArray<FLeaderboardRow>& Rows, FLeaderboardChangeSet* OutChanges, int32 LocalUserNum)
+{
+    FLeaderboardBoard* Board = Boards.Find(BoardKey);
+    if (!Board)
+    {
+        Board = &Boards.Add(BoardKey, FLeaderboardBoard(LeaderboardPageSize));
+    }
+    Board->bViewDirty = true;
+
+    FLeaderboardRankIndex& RankIndex = Board->RankIndex;
+    if (bFriendsOnly)
+    {
+        // Friends rows carry sparse global ranks, so they go to their own index instead of the rank pages
+        if (OutChanges)
+        {
+            TArray<FLeaderboardRow> OldRows;
+            Board->GetViewIndex().ToArray(OldRows);
+            DiffRows(OldRows, Rows, *OutChanges);
+        }
+        Board->bShowingFriends = true;
+        Board->ViewUserNum = LocalUserNum;
+        FLeaderboardUserState& User = Board->GetUser(LocalUserNum);
+        User.bFriendsLoaded = true;
+        User.FriendsFetchTime = FPlatformTime::Seconds();
+        FLeaderboardRankIndex& FriendsIndex = User.FriendsIndex;
+        FriendsIndex.Reset();
+        FriendsIndex.Reserve(Rows.Num());
+        for (const FLeaderboardRow& Row : Rows)
+        {
+            FriendsIndex.Upsert(Row);
+        }
+        return;
+    }
+
+    bSnapshotDirty = true;
+
+    // Leaving the friends view changes every visible row, otherwise the window's own rows are the whole diff
+    const bool bLeavingFriends = Board->bShowingFriends;
+    FLeaderboardChangeSet* WindowChanges = bLeavingFriends ? nullptr : OutChanges;
+    TArray<FLeaderboardRow> FriendsRows;
+    if (bLeavingFriends && OutChanges)
+    {
+        Board->GetViewIndex().ToArray(FriendsRows);
+    }
+    Board->bShowingFriends = false;
+
+    FLeaderboardPagedStore& Store = Board->Store;
+    TArray<FLeaderboardRow> Dropped;
+    Store.MergeWindow(RankFirst, RankCount, Rows, Dropped);
+    TSet<int32> DroppedPlayers;
+    DroppedPlayers.Reserve(Dropped.Num());
+    for (const FLeaderboardRow& Row : Dropped)
+    {
+        // A tie can drop a row this read brought in for the first time, which was never shown
+        if (RankIndex.Remove(Row.PlayerHandle) && WindowChanges)
+        {
+            WindowChanges->Removed.Add(MakeRowChange(&Row, nullptr));
+        }
+        DroppedPlayers.Add(Row.PlayerHandle);
+    }
+    for (const FLeaderboardRow& Row : Rows)
+    {
+        // A row that lost its rank to a tied one later in the read isn't in the store, so it stays out of the index too
+        if (DroppedPlayers.Contains(Row.PlayerHandle))
+        {
+            continue;
+        }
+        if (WindowChanges)
+        {
+            AddRowChange(RankIndex.FindPlayer(Row.PlayerHandle), Row, *WindowChanges);
+        }
+        RankIndex.Upsert(Row);
+    }
+
+    Dropped.Reset();
+    Store.EvictToBudget(MaxResidentRowsPerBoard, Dropped);
+    for (const FLeaderboardRow& Row : Dropped)
+    {
+        if (WindowChanges)
+        {
+            WindowChanges->Removed.Add(MakeRowChange(&Row, nullptr));
+        }
+        RankIndex.Remove(Row.PlayerHandle);
+    }
+
+    if (bLeavingFriends && OutChanges)
+    {
+        TArray<FLeaderboardRow> GlobalRows;
+        RankIndex.ToArray(GlobalRows);
+        DiffRows(FriendsRows, GlobalRows, *OutChanges);
+    }
+}
+
+FLeaderboardEntry ULeaderboardManager::MakeEntry(const FLeaderboardRow& Row) const
+{
+    FLeaderboardEntry Entry;
+    Entry.PlayerName = NameTable.Get(Row.NameHandle);
+    Entry.PlayerId = NameTable.Get(Row.PlayerHandle);
+    Entry.Score = Row.Score;
+    Entry.Rank = Row.Rank;
+    return Entry;
+}
+
+FLeaderboardRowChange ULeaderboardManager::MakeRowChange(const FLeaderboardRow* OldRow, const FLeaderboardRow* NewRow) const
+{
+    const FLeaderboardRow& Row = NewRow ? *NewRow : *OldRow;
+    FLeaderboardRowChange Change;
+    Change.PlayerId = NameTable.Get(Row.PlayerHandle);
+    Change.PlayerName = NameTable.Get(Row.NameHandle);
+    if (OldRow)
+    {
+        Change.OldRank = OldRow->Rank;
+        Change.OldScore = OldRow->Score;
+    }
+    if (NewRow)
+    {
+        Change.NewRank = NewRow->Rank;
+        Change.NewScore = NewRow->Score;
+    }
+    return Change;
+}
+
+void ULeaderboardManager::AddRowChange(const FLeaderboardRow* OldRow, const FLeaderboardRow& NewRow, FLeaderboardChangeSet& OutChanges) const
+{
+    if (!OldRow)
+    {
+        OutChanges.Inserted.Add(MakeRowChange(nullptr, &NewRow));
+    }
+    else if (OldRow->Score != NewRow.Score)
+    {
+        OutChanges.ScoreChanged.Add(MakeRowChange(OldRow, &NewRow));
+    }
+    else if (OldRow->Rank != NewRow.Rank)
+    {
+        OutChanges.RankMoved.Add(MakeRowChange(OldRow, &NewRow));
+    }
+}
+
+void ULeaderboardManager::DiffRows(const TArray<FLeaderboardRow>& OldRows, const TArray<FLeaderboardRow>& NewRows, FLeaderboardChangeSet& OutChanges) const
+{
+    TMap<int32, const FLeaderboardRow*> OldByPlayer;
+    OldByPlayer.Reserve(OldRows.Num());
+    for (const FLeaderboardRow& Row : OldRows)
+    {
+        OldByPlayer.Add(Row.PlayerHandle, &Row);
+    }
+    for (const FLeaderboardRow& Row : NewRows)
+    {
+        const FLeaderboardRow* OldRow = nullptr;
+        OldByPlayer.RemoveAndCopyValue(Row.PlayerHandle, OldRow);
+        AddRowChange(OldRow, Row, OutChanges);
+    }
+    for (const TPair<int32, const FLeaderboardRow*>& Pair : OldByPlayer)
+    {
+        OutChanges.Removed.Add(MakeRowChange(Pair.Value, nullptr));
+    }
+}
+
+const TArray<FLeaderboardEntry>& ULeaderboardManager::GetEntryView(FName BoardKey, const FLeaderboardBoard& Board) const
+{
+    TArray<FLeaderboardEntry>& View = LeaderboardEntries.FindOrAdd(BoardKey.ToString());
+    if (Board.bViewDirty)
+    {
+        // The index already holds the rows in board order, so the view is a straight walk
+        TArray<FLeaderboardRow> Rows;
+        Board.GetViewIndex().ToArray(Rows);
+        View.Reset(Rows.Num());
+        for (const FLeaderboardRow& Row : Rows)
+        {
+            View.Add(MakeEntry(Row));
+        }
+        Board.bViewDirty = false;
+    }
+    return View;
+}
+
+const FLeaderboardBoard* ULeaderboardManager::FindBoard(const FString& LeaderboardName) const
+{
+    const FName BoardKey(*LeaderboardName, FNAME_Find);
+    return BoardKey.IsNone() ? nullptr : Boards.Find(BoardKey);
+}
+
+FLeaderboardBoard* ULeaderboardManager::FindBoard(const FString& LeaderboardName)
+{
+    const FName BoardKey(*LeaderboardName, FNAME_Find);
+    return BoardKey.IsNone() ? nullptr : Boards.Find(BoardKey);
+}
+
+TArray<FLeaderboardRankRange> ULeaderboardManager::GetResidentRanges(const FString& LeaderboardName) const
+{
+    TArray<FLeaderboardRankRange> Ranges;
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        Board->Store.GetResidentRanges(Ranges);
+    }
+    return Ranges;
+}
+
+TArray<FLeaderboardRankRange> ULeaderboardManager::GetMissingRanges(const FString& LeaderboardName, int32 RankFirst, int32 RankCount) const
+{
+    TArray<FLeaderboardRankRange> Ranges;
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        Board->Store.GetMissingRanges(RankFirst, RankCount, Ranges);
+    }
+    else if (RankCount > 0)
+    {
+        FLeaderboardRankRange& Range = Ranges.AddDefaulted_GetRef();
+        Range.RankFirst = RankFirst;
+        Range.RankCount = RankCount;
+    }
+    return Ranges;
+}
+
+void ULeaderboardManager::MarkRangeViewed(const FString& LeaderboardName, int32 RankFirst, int32 RankCount)
+{
+    if (FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        Board->Store.Touch(RankFirst, RankCount);
+    }
+}
+
+int32 ULeaderboardManager::ReadMissingLeaderboardRanges(const FString& WorldName, const FString& LeaderboardName, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
+{
+    const int32 LeaderboardHandle = FindLeaderboardHandle(LeaderboardName);
+    if (!GetLeaderboardMapping(LeaderboardHandle))
+    {
+        return 0;
+    }
+
+    MarkRangeViewed(LeaderboardName, RankFirst, RankCount);
+
+    int32 ReadsIssued = 0;
+    for (const FLeaderboardRankRange& Range : GetMissingRanges(LeaderboardName, RankFirst, RankCount))
+    {
+        if (ReadLeaderboardByHandle(WorldName, LeaderboardHandle, false, Range.RankFirst, Range.RankCount, DoNotShowWindow) != INDEX_NONE)
+        {
+            ++ReadsIssued;
+        }
+    }
+    return ReadsIssued;
+}
+
+void ULeaderboardManager::InvalidateLeaderboardCache(const FString& LeaderboardName)
+{
+    InvalidateCachedQueries(FName(*LeaderboardName));
+}
+
+void ULeaderboardManager::InvalidateCachedQueries(FName BoardName)
+{
+    for (TPair<FLeaderboardQueryKey, FLeaderboardCachedQuery>& Cached : QueryCache)
+    {
+        if (Cached.Key.LeaderboardName == BoardName)
+        {
+            // Keep the rows so they can still be served stale while the refresh runs
+            Cached.Value.FetchTime = FMath::Min(Cached.Value.FetchTime, FPlatformTime::Seconds() - QueryCacheTTL - 1.0);
+        }
+    }
+}
+
+void ULeaderboardManager::ClearLeaderboardCache()
+{
+    QueryCache.Empty();
+}
+
+void ULeaderboardManager::PruneQueryCache(double Now)
+{
+    LastQueryCachePruneTime = Now;
+    if (QueryCacheTTL <= 0.0f)
+    {
+        QueryCache.Empty();
+        return;
+    }
+
+    // Past the stale lifetime an entry can only be dropped by its next lookup, which may never come
+    const double MaxAge = QueryCacheTTL + QueryCacheStaleLifetime;
+    for (auto It = QueryCache.CreateIterator(); It; ++It)
+    {
+        if (Now - It.Value().FetchTime > MaxAge)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    const int32 NumOverCap = QueryCache.Num() - MaxCachedQueries;
+    if (MaxCachedQueries <= 0 || NumOverCap <= 0)
+    {
+        return;
+    }
+
+    // Runs after every read that fills the cache, so the oldest entries come off one heap built in a single pass
+    // instead of a scan of the whole map per eviction
+    typedef TPair<double, FLeaderboardQueryKey> FCacheAge;
+    TArray<FCacheAge> ByAge;
+    ByAge.Reserve(QueryCache.Num());
+    for (const TPair<FLeaderboardQueryKey, FLeaderboardCachedQuery>& Pair : QueryCache)
+    {
+        ByAge.Emplace(Pair.Value.FetchTime, Pair.Key);
+    }
+    auto OlderFirst = [](const FCacheAge& A, const FCacheAge& B) { return A.Key < B.Key; };
+    ByAge.Heapify(OlderFirst);
+    for (int32 Evicted = 0; Evicted < NumOverCap; ++Evicted)
+    {
+        FCacheAge Oldest;
+        ByAge.HeapPop(Oldest, OlderFirst);
+        QueryCache.Remove(Oldest.Value);
+    }
+}
+
+void ULeaderboardManager::CompactNameTable(double Now)
+{
+    LastNameTableCheckTime = Now;
+
+    // Evicted pages, replaced friends rows and re-read windows leave their strings behind. Each live row holds at most
+    // two handles, so this bound is cheap and only overcounts rows held in more than one place.
+    int32 MaxLiveHandles = 0;
+    for (const TPair<FName, FLeaderboardBoard>& Pair : Boards)
+    {
+        const FLeaderboardBoard& Board = Pair.Value;
+        MaxLiveHandles += 2 * (Board.Store.NumRows() + Board.RankIndex.Num() + Board.PlayersIndex.Num());
+        for (const TPair<int32, FLeaderboardUserState>& User : Board.Users)
+        {
+            MaxLiveHandles += 2 * User.Value.FriendsIndex.Num();
+        }
+    }
+    for (const TPair<FLeaderboardQueryKey, FLeaderboardCachedQuery>& Cached : QueryCache)
+    {
+        MaxLiveHandles += 2 * Cached.Value.Rows.Num();
+    }
+    if (NameTable.Num() <= 2 * MaxLiveHandles)
+    {
+        return;
+    }
+
+    TBitArray<> Live(false, NameTable.Num());
+    for (const TPair<FName, FLeaderboardBoard>& Pair : Boards)
+    {
+        const FLeaderboardBoard& Board = Pair.Value;
+        Board.Store.MarkHandles(Live);
+        Board.RankIndex.MarkHandles(Live);
+        Board.PlayersIndex.MarkHandles(Live);
+        for (const TPair<int32, FLeaderboardUserState>& User : Board.Users)
+        {
+            User.Value.FriendsIndex.MarkHandles(Live);
+        }
+    }
+    for (const TPair<FLeaderboardQueryKey, FLeaderboardCachedQuery>& Cached : QueryCache)
+    {
+        for (const FLeaderboardRow& Row : Cached.Value.Rows)
+        {
+            for (const int32 Handle : { Row.PlayerHandle, Row.NameHandle })
+            {
+                if (Live.IsValidIndex(Handle))
+                {
+                    Live[Handle] = true;
+                }
+            }
+        }
+    }
+
+    const int32 NumBefore = NameTable.Num();
+    TArray<int32> Remap;
+    NameTable.Compact(Live, Remap);
+    for (TPair<FName, FLeaderboardBoard>& Pair : Boards)
+    {
+        FLeaderboardBoard& Board = Pair.Value;
+        Board.Store.RemapHandles(Remap);
+        Board.RankIndex.RemapHandles(Remap);
+        Board.PlayersIndex.RemapHandles(Remap);
+        for (TPair<int32, FLeaderboardUserState>& User : Board.Users)
+        {
+            User.Value.FriendsIndex.RemapHandles(Remap);
+        }
+    }
+    for (TPair<FLeaderboardQueryKey, FLeaderboardCachedQuery>& Cached : QueryCache)
+    {
+        for (FLeaderboardRow& Row : Cached.Value.Rows)
+        {
+            Row.PlayerHandle = Remap.IsValidIndex(Row.PlayerHandle) ? Remap[Row.PlayerHandle] : INDEX_NONE;
+            Row.NameHandle = Remap.IsValidIndex(Row.NameHandle) ? Remap[Row.NameHandle] : INDEX_NONE;
+        }
+    }
+    UE_LOG(LogLeaderboard, Verbose, TEXT("Compacted the leaderboard name table from %d to %d strings."), NumBefore, NameTable.Num());
+}
+
+void ULeaderboardManager::ExpireStalledReads(double Now)
+{
+    if (ReadTimeout <= 0.0f)
+    {
+        return;
+    }
+
+    // Only reads the backend never answered; answered ones are parsing and finish on their own
+    TArray<int32, TInlineAllocator<8>> Stalled;
+    for (const TPair<int32, FLeaderboardReadRequest>& Pair : InFlightReads)
+    {
+        if (Pair.Value.DelegateHandle.IsValid() && Now - Pair.Value.StartTime > ReadTimeout)
+        {
+            Stalled.Add(Pair.Key);
+        }
+    }
+
+    IOnlineLeaderboardsPtr Leaderboards = GetLeaderboardsInterface();
+    for (const int32 RequestId : Stalled)
+    {
+        FLeaderboardReadRequest& Request = InFlightReads.FindChecked(RequestId);
+        if (Leaderboards.IsValid())
+        {
+            Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(Request.DelegateHandle);
+        }
+        Request.DelegateHandle.Reset();
+        ++Metrics.ReadsTimedOut;
+        UE_LOG(LogLeaderboard, Warning, TEXT("Leaderboard read %d timed out after %.0f seconds."), RequestId, Now - Request.StartTime);
+
+        // Fails the waiters that joined it as well, and frees the query key for the next identical read
+        FinishLeaderboardRead(RequestId, Request.LeaderboardName, false, nullptr);
+    }
+}
+
+int32 ULeaderboardManager::ReadLeaderboards(const FString& WorldName, const TArray<FString>& LeaderboardNames, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow)
+{
+    const int32 BatchId = NextReadBatchId++;
+    FLeaderboardReadBatch& NewBatch = ReadBatches.Add(BatchId);
+    NewBatch.bFriendsOnly = bFriendsOnly;
+    NewBatch.bDoNotShowWindow = DoNotShowWindow;
+    NewBatch.NumPending = LeaderboardNames.Num();
+    NewBatch.Results.SetNum(LeaderboardNames.Num());
+
+    // Every read is issued before any completion is handled, so the boards share one round trip.
+    // Backends take one board per FOnlineLeaderboardRead, so they can't be merged into a single read.
+    const int32 OuterBuildingBatchId = BuildingBatchId;
+    TMap<int32, bool> OuterCompletions = MoveTemp(BuildingBatchCompletions);
+    BuildingBatchId = BatchId;
+    BuildingBatchCompletions.Reset();
+
+    TArray<int32> RequestIds;
+    RequestIds.Reserve(LeaderboardNames.Num());
+    for (const FString& LeaderboardName : LeaderboardNames)
+    {
+        RequestIds.Add(ReadLeaderboard(WorldName, LeaderboardName, bFriendsOnly, RankFirst, RankCount, true));
+    }
+
+    TMap<int32, bool> Completed = MoveTemp(BuildingBatchCompletions);
+    BuildingBatchId = OuterBuildingBatchId;
+    BuildingBatchCompletions = MoveTemp(OuterCompletions);
+
+    if (LeaderboardNames.Num() == 0)
+    {
+        ReadBatches.Remove(BatchId);
+        OnLeaderboardBatchReadCompleted.Broadcast(BatchId, TArray<FLeaderboardBoardReadStatus>());
+        return BatchId;
+    }
+
+    for (int32 Slot = 0; Slot < RequestIds.Num(); ++Slot)
+    {
+        const int32 RequestId = RequestIds[Slot];
+        if (FLeaderboardReadBatch* Batch = ReadBatches.Find(BatchId))
+        {
+            Batch->Results[Slot].LeaderboardName = LeaderboardNames[Slot];
+            Batch->Results[Slot].RequestId = RequestId;
+        }
+
+        if (RequestId == INDEX_NONE)
+        {
+            CompleteBatchSlot(BatchId, Slot, false);
+        }
+        else if (const bool* bWasSuccessful = Completed.Find(RequestId))
+        {
+            CompleteBatchSlot(BatchId, Slot, *bWasSuccessful);
+        }
+        else
+        {
+            BatchSlotByRequest.Add(RequestId, TPair<int32, int32>(BatchId, Slot));
+        }
+    }
+    return BatchId;
+}
+
+void ULeaderboardManager::CompleteBatchSlot(int32 BatchId, int32 Slot, bool bWasSuccessful)
+{
+    FLeaderboardReadBatch* Batch = ReadBatches.Find(BatchId);
+    if (!Batch)
+    {
+        return;
+    }
+
+    Batch->Results[Slot].bWasSuccessful = bWasSuccessful;
+    if (--Batch->NumPending > 0)
+    {
+        return;
+    }
+
+    // Copied out first, handlers are free to start another batch
+    FLeaderboardReadBatch Finished;
+    ReadBatches.RemoveAndCopyValue(BatchId, Finished);
+    if (!Finished.bDoNotShowWindow)
+    {
+        OnLeaderboardWindowShow.Broadcast(Finished.bFriendsOnly);
+    }
+    OnLeaderboardBatchReadCompleted.Broadcast(BatchId, Finished.Results);
+}
+
+bool ULeaderboardManager::IsReadInFlight(int32 RequestId) const
+{
+    if (InFlightReads.Contains(RequestId))
+    {
+        return true;
+    }
+    for (const TPair<int32, FLeaderboardReadRequest>& Pending : InFlightReads)
+    {
+        if (Pending.Value.Waiters.ContainsByPredicate([RequestId](const FLeaderboardReadWaiter& Waiter) { return Waiter.RequestId == RequestId; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const TMap<FString, TArray<FLeaderboardEntry>>& ULeaderboardManager::GetLeaderboardEntries() const
+{
+    for (const TPair<FName, FLeaderboardBoard>& Board : Boards)
+    {
+        GetEntryView(Board.Key, Board.Value);
+    }
+    return LeaderboardEntries;
+}
+
+const TArray<FLeaderboardEntry>& ULeaderboardManager::GetLeaderboardByName(const FString& LeaderboardName) const
+{
+    const FName BoardKey(*LeaderboardName, FNAME_Find);
+    if (const FLeaderboardBoard* Board = BoardKey.IsNone() ? nullptr : Boards.Find(BoardKey))
+    {
+        return GetEntryView(BoardKey, *Board);
+    }
+
+    static const TArray<FLeaderboardEntry> EmptyArray;
+    return EmptyArray;
+}
+
+const FLeaderboardRankIndex* ULeaderboardManager::GetRankIndex(const FString& LeaderboardName) const
+{
+    const FLeaderboardBoard* Board = FindBoard(LeaderboardName);
+    return Board ? &Board->GetViewIndex() : nullptr;
+}
+
+const FLeaderboardNameTable& ULeaderboardManager::GetNameTable() const
+{
+    return NameTable;
+}
+
+TArray<FLeaderboardEntry> ULeaderboardManager::GetEntriesAroundPlayer(const FString& LeaderboardName, const FString& PlayerId, int32 Radius, int32 LocalUserNum) const
+{
+    TArray<FLeaderboardEntry> Result;
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        const int32 PlayerHandle = NameTable.Find(PlayerId.IsEmpty() ? GetLocalPlayerId(LocalUserNum) : PlayerId);
+        if (PlayerHandle != INDEX_NONE)
+        {
+            TArray<FLeaderboardRow> Rows;
+            Board->GetViewIndex().GetEntriesAround(PlayerHandle, Radius, Rows);
+            Result.Reserve(Rows.Num());
+            for (const FLeaderboardRow& Row : Rows)
+            {
+                Result.Add(MakeEntry(Row));
+            }
+        }
+    }
+    return Result;
+}
+
+FLeaderboardRankProjection ULeaderboardManager::GetLocalRankProjection(const FString& LeaderboardName, int32 Radius, int32 LocalUserNum) const
+{
+    FLeaderboardRankProjection Projection;
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        const FLeaderboardUserState* User = Board->FindUser(LocalUserNum);
+        ProjectLocalRank(*Board, LocalUserNum, User ? User->ProvisionalScore : MIN_int32, FMath::Max(Radius, 0), Projection);
+    }
+    return Projection;
+}
+
+void ULeaderboardManager::ProjectLocalRank(const FLeaderboardBoard& Board, int32 LocalUserNum, int32 Score, int32 Radius, FLeaderboardRankProjection& OutProjection) const
+{
+    const FLeaderboardRankIndex& RankIndex = Board.RankIndex;
+    const FLeaderboardUserState* User = Board.FindUser(LocalUserNum);
+    const int32 LastReportedRank = User ? User->LocalPlayerRank : -1;
+    const FString LocalId = GetLocalPlayerId(LocalUserNum);
+    const int32 LocalHandle = NameTable.Find(LocalId);
+    const FLeaderboardRow* LocalRow = LocalHandle != INDEX_NONE ? RankIndex.FindPlayer(LocalHandle) : nullptr;
+
+    if (Score == MIN_int32 || (LocalRow && LocalRow->Score >= Score))
+    {
+        // Nothing pending or the backend already has something at least as good, report what was read
+        OutProjection.bProvisional = false;
+        OutProjection.Rank = LocalRow ? LocalRow->Rank : LastReportedRank;
+        OutProjection.Score = LocalRow ? LocalRow->Score : 0;
+        TArray<FLeaderboardRow> Rows;
+        if (LocalRow)
+        {
+            RankIndex.GetEntriesAround(LocalHandle, Radius, Rows);
+        }
+        for (const FLeaderboardRow& Row : Rows)
+        {
+            OutProjection.Neighbours.Add(MakeEntry(Row));
+        }
+        return;
+    }
+
+    OutProjection.bProvisional = true;
+    OutProjection.Score = Score;
+
+    // Rows scoring at or above the new score keep their place, ties included; the local row's old entry always
+    // scores lower so it sits at or after the insertion point
+    const int32 Position = RankIndex.CountScoresAbove(Score - 1);
+    if (const FLeaderboardRow* Below = RankIndex.GetEntryAt(Position))
+    {
+        OutProjection.Rank = Below->Rank;
+    }
+    else if (const FLeaderboardRow* Last = RankIndex.GetEntryAt(RankIndex.Num() - 1))
+    {
+        OutProjection.Rank = Last->PlayerHandle == LocalHandle ? Last->Rank : Last->Rank + 1;
+    }
+    else
+    {
+        OutProjection.Rank = LastReportedRank;
+    }
+
+    // One extra row below in case the old local entry falls inside the window and gets skipped
+    const int32 FirstPosition = FMath::Max(Position - Radius, 0);
+    TArray<FLeaderboardRow> Rows;
+    RankIndex.GetRange(FirstPosition, Position - FirstPosition + Radius + 1, Rows);
+
+    FLeaderboardEntry LocalEntry;
+    LocalEntry.PlayerId = LocalId;
+    LocalEntry.Score = Score;
+    LocalEntry.Rank = OutProjection.Rank;
+    if (LocalRow)
+    {
+        LocalEntry.PlayerName = NameTable.Get(LocalRow->NameHandle);
+    }
+    else if (IOnlineIdentityPtr Identity = GetIdentityInterface())
+    {
+        LocalEntry.PlayerName = Identity->GetPlayerNickname(LocalUserNum);
+    }
+
+    OutProjection.Neighbours.Reserve(Radius * 2 + 1);
+    bool bAddedLocal = false;
+    int32 NumBelow = 0;
+    for (int32 Index = 0; Index < Rows.Num() && NumBelow < Radius; ++Index)
+    {
+        const FLeaderboardRow& Row = Rows[Index];
+        if (FirstPosition + Index < Position)
+        {
+            OutProjection.Neighbours.Add(MakeEntry(Row));
+            continue;
+        }
+        if (!bAddedLocal)
+        {
+            OutProjection.Neighbours.Add(LocalEntry);
+            bAddedLocal = true;
+        }
+        if (Row.PlayerHandle == LocalHandle)
+        {
+            continue;
+        }
+        // Only rows between the new and the old position are pushed down, the rest keep their rank
+        FLeaderboardEntry& Entry = OutProjection.Neighbours.Add_GetRef(MakeEntry(Row));
+        if (!LocalRow || Row.Rank < LocalRow->Rank)
+        {
+            ++Entry.Rank;
+        }
+        ++NumBelow;
+    }
+    if (!bAddedLocal)
+    {
+        OutProjection.Neighbours.Add(LocalEntry);
+    }
+}
+
+int32 ULeaderboardManager::GetPlayerRank(const FString& LeaderboardName, const FString& PlayerId, int32 LocalUserNum) const
+{
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        const int32 PlayerHandle = NameTable.Find(PlayerId.IsEmpty() ? GetLocalPlayerId(LocalUserNum) : PlayerId);
+        if (const FLeaderboardRow* Row = Board->GetViewIndex().FindPlayer(PlayerHandle))
+        {
+            return Row->Rank;
+        }
+        if (PlayerId.IsEmpty())
+        {
+            // The local row may have been evicted or belong to the other view, the last reported rank still holds
+            const FLeaderboardUserState* User = Board->FindUser(LocalUserNum);
+            return User ? User->LocalPlayerRank : -1;
+        }
+        if (const FLeaderboardRow* Row = Board->PlayersIndex.FindPlayer(PlayerHandle))
+        {
+            return Row->Rank;
+        }
+    }
+    return -1;
+}
+
+TArray<FLeaderboardEntry> ULeaderboardManager::GetFriendsLeaderboard(const FString& LeaderboardName, int32 LocalUserNum) const
+{
+    TArray<FLeaderboardEntry> Result;
+    const FLeaderboardBoard* Board = FindBoard(LeaderboardName);
+    if (const FLeaderboardUserState* User = Board ? Board->FindUser(LocalUserNum) : nullptr)
+    {
+        TArray<FLeaderboardRow> Rows;
+        User->FriendsIndex.ToArray(Rows);
+        Result.Reserve(Rows.Num());
+        for (const FLeaderboardRow& Row : Rows)
+        {
+            Result.Add(MakeEntry(Row));
+        }
+    }
+    return Result;
+}
+
+int32 ULeaderboardManager::GetFriendRank(const FString& LeaderboardName, const FString& PlayerId, int32 LocalUserNum) const
+{
+    const FLeaderboardBoard* Board = FindBoard(LeaderboardName);
+    if (const FLeaderboardUserState* User = Board ? Board->FindUser(LocalUserNum) : nullptr)
+    {
+        const int32 PlayerHandle = NameTable.Find(PlayerId.IsEmpty() ? GetLocalPlayerId(LocalUserNum) : PlayerId);
+        const int32 Position = PlayerHandle != INDEX_NONE ? User->FriendsIndex.GetPositionOfPlayer(PlayerHandle) : INDEX_NONE;
+        if (Position != INDEX_NONE)
+        {
+            return Position + 1;
+        }
+    }
+    return -1;
+}
+
+TArray<FLeaderboardEntry> ULeaderboardManager::GetFriendsBeatenByScore(const FString& LeaderboardName, int32 Score, int32 LocalUserNum) const
+{
+    TArray<FLeaderboardEntry> Result;
+    const FLeaderboardBoard* Board = FindBoard(LeaderboardName);
+    const FLeaderboardUserState* User = Board ? Board->FindUser(LocalUserNum) : nullptr;
+    if (!User || Score == MIN_int32)
+    {
+        return Result;
+    }
+
+    // Friends between the first one scoring below Score and the user's own row; ties aren't beaten
+    const FLeaderboardRankIndex& FriendsIndex = User->FriendsIndex;
+    const int32 LocalHandle = NameTable.Find(GetLocalPlayerId(LocalUserNum));
+    const int32 LocalPosition = LocalHandle != INDEX_NONE ? FriendsIndex.GetPositionOfPlayer(LocalHandle) : INDEX_NONE;
+    const int32 FirstPosition = FriendsIndex.CountScoresAbove(Score - 1);
+    const int32 EndPosition = LocalPosition != INDEX_NONE ? LocalPosition : FriendsIndex.Num();
+    if (EndPosition > FirstPosition)
+    {
+        TArray<FLeaderboardRow> Rows;
+        FriendsIndex.GetRange(FirstPosition, EndPosition - FirstPosition, Rows);
+        Result.Reserve(Rows.Num());
+        for (const FLeaderboardRow& Row : Rows)
+        {
+            Result.Add(MakeEntry(Row));
+        }
+    }
+    return Result;
+}
+
+FLeaderboardMetrics ULeaderboardManager::GetMetrics() const
+{
+    FLeaderboardMetrics Current = Metrics;
+    Current.InFlightReads = InFlightReads.Num();
+    Current.PendingWrites = PendingWrites.Num();
+    Current.SessionsAwaitingFlush = WritesAwaitingFlush.Num();
+    Current.JournalOutstanding = WriteJournal.NumOutstanding();
+    Current.ResidentBoards = Boards.Num();
+    for (const TPair<FName, FLeaderboardBoard>& Board : Boards)
+    {
+        Current.ResidentRows += Board.Value.Store.NumRows();
+        Current.BoardBytes += Board.Value.Store.GetAllocatedSize() + Board.Value.RankIndex.GetAllocatedSize() + Board.Value.PlayersIndex.GetAllocatedSize();
+        for (const TPair<int32, FLeaderboardUserState>& User : Board.Value.Users)
+        {
+            Current.BoardBytes += User.Value.FriendsIndex.GetAllocatedSize();
+        }
+    }
+    Current.NameTableBytes = NameTable.GetAllocatedSize();
+
+    Current.EntryViewBytes = LeaderboardEntries.GetAllocatedSize();
+    for (const TPair<FString, TArray<FLeaderboardEntry>>& View : LeaderboardEntries)
+    {
+        Current.EntryViewBytes += View.Key.GetAllocatedSize() + View.Value.GetAllocatedSize();
+        for (const FLeaderboardEntry& Entry : View.Value)
+        {
+            Current.EntryViewBytes += Entry.PlayerName.GetAllocatedSize() + Entry.PlayerId.GetAllocatedSize();
+        }
+    }
+    return Current;
+}
+
+void ULeaderboardManager::ResetMetrics()
+{
+    Metrics = FLeaderboardMetrics();
+}
+
+void ULeaderboardManager::UpdateStatGauges() const
+{
+    SET_DWORD_STAT(STAT_LeaderboardInFlightReads, InFlightReads.Num());
+    SET_DWORD_STAT(STAT_LeaderboardPendingWrites, PendingWrites.Num());
+    TRACE_COUNTER_SET(LeaderboardInFlightReads, InFlightReads.Num());
+    TRACE_COUNTER_SET(LeaderboardPendingWrites, PendingWrites.Num());
+#if STATS
+    SET_MEMORY_STAT(STAT_LeaderboardEntryViewMemory, GetMetrics().EntryViewBytes);
+#endif
+}
+
+FDateTime ULeaderboardManager::GetLeaderboardFetchTime(const FString& LeaderboardName) const
+{
+    const FLeaderboardBoard* Board = FindBoard(LeaderboardName);
+    return Board ? Board->LastFetchTime : FDateTime();
+}
+
+bool ULeaderboardManager::GetEntryAtPosition(const FString& LeaderboardName, int32 Position, FLeaderboardEntry& OutEntry) const
+{
+    if (const FLeaderboardBoard* Board = FindBoard(LeaderboardName))
+    {
+        if (const FLeaderboardRow* Row = Board->GetViewIndex().GetEntryAt(Position))
+        {
+            OutEntry = MakeEntry(*Row);
+            return true;
+        }
+    }
+    return false;
+}
+
+FString ULeaderboardManager::GetLocalPlayerId(int32 LocalUserNum) const
+{
+    FUniqueNetIdPtr UserId = GetLocalUserId(LocalUserNum);
+    return UserId.IsValid() ? UserId->ToString() : FString();
+}
+
+FUniqueNetIdPtr ULeaderboardManager::GetLocalUserId(int32 LocalUserNum) const
+{
+    IOnlineIdentityPtr Identity = GetIdentityInterface();
+    return Identity.IsValid() ? Identity->GetUniquePlayerId(LocalUserNum) : nullptr;
+}
+
+void ULeaderboardManager::SetOnlineInterfacesOverride(IOnlineLeaderboardsPtr InLeaderboards, IOnlineIdentityPtr InIdentity)
+{
+    LeaderboardsOverride = InLeaderboards;
+    IdentityOverride = InIdentity;
+    if (Backend.IsValid())
+    {
+        Backend->Bind(IOnlineSubsystem::Get(), LeaderboardsOverride, IdentityOverride);
+    }
+}
+
+IOnlineLeaderboardsPtr ULeaderboardManager::GetLeaderboardsInterface() const
+{
+    return Backend.IsValid() ? Backend->GetLeaderboards() : nullptr;
+}
+
+IOnlineIdentityPtr ULeaderboardManager::GetIdentityInterface() const
+{
+    return Backend.IsValid() ? Backend->GetIdentity() : nullptr;
+}
+
+void ULeaderboardManager::OnLeaderboardReadComplete(bool bWasSuccessful, FOnlineLeaderboardReadRef LeaderboardReadRef, int32 RequestId)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::OnLeaderboardReadComplete);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardReadComplete);
+
+    // The read-complete delegate fires for every outstanding read, so skip completions that belong to another request
+    if (LeaderboardReadRef->ReadState == EOnlineAsyncTaskState::NotStarted || LeaderboardReadRef->ReadState == EOnlineAsyncTaskState::InProgress)
+    {
+        return;
+    }
+
+    FLeaderboardReadRequest* Request = InFlightReads.Find(RequestId);
+    if (!Request || !Request->DelegateHandle.IsValid())
+    {
+        return;
+    }
+    bWasSuccessful = bWasSuccessful && LeaderboardReadRef->ReadState == EOnlineAsyncTaskState::Done;
+
+    IOnlineLeaderboardsPtr Leaderboards = GetLeaderboardsInterface();
+    if (Leaderboards)
+    {
+        Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(Request->DelegateHandle);
+    }
+    // A cleared handle marks the request as answered; it stays in flight until its rows are merged
+    Request->DelegateHandle.Reset();
+
+    // The read object carries the backend's board name, boards are kept under the display name the request was made with
+    const FName BoardKey = Request->LeaderboardName;
+    if (!bWasSuccessful)
+    {
+        FinishLeaderboardRead(RequestId, BoardKey, false, nullptr);
+        return;
+    }
+
+    FLeaderboardParsedReadPtr Parsed = AcquireParseBuffer();
+    const FString LocalPlayerId = GetLocalPlayerId(Request->LocalUserNum);
+    if (!bParseReadsAsync || LeaderboardReadRef->Rows.Num() < AsyncParseRowThreshold)
+    {
+        ParseLeaderboardRows(*LeaderboardReadRef, LocalPlayerId, *Parsed);
+        FinishLeaderboardRead(RequestId, BoardKey, true, Parsed);
+        return;
+    }
+
+    // The worker only touches the read object and its own buffer; the board is merged back on the game thread
+    TWeakObjectPtr<ULeaderboardManager> WeakThis(this);
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, LeaderboardReadRef, LocalPlayerId, Parsed, RequestId, BoardKey]()
+    {
+        ParseLeaderboardRows(*LeaderboardReadRef, LocalPlayerId, *Parsed);
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Parsed, RequestId, BoardKey]()
+        {
+            if (ULeaderboardManager* Manager = WeakThis.Get())
+            {
+                Manager->FinishLeaderboardRead(RequestId, BoardKey, true, Parsed);
+            }
+        });
+    });
+}
+
+void ULeaderboardManager::FinishLeaderboardRead(int32 RequestId, FName BoardKey, bool bWasSuccessful, FLeaderboardParsedReadPtr Parsed)
+{
+    FLeaderboardReadRequest Request;
+    if (!InFlightReads.RemoveAndCopyValue(RequestId, Request))
+    {
+        return;
+    }
+    const FLeaderboardQueryKey QueryKey = Request.GetQueryKey();
+    if (InFlightQueries.FindRef(QueryKey) == RequestId)
+    {
+        InFlightQueries.Remove(QueryKey);
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::FinishLeaderboardRead);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardMergeRows);
+    Metrics.ReadLatency.Add(FPlatformTime::Seconds() - Request.StartTime);
+    if (bWasSuccessful)
+    {
+        ++Metrics.ReadsSucceeded;
+    }
+    else
+    {
+        ++Metrics.ReadsFailed;
+    }
+
+    FLeaderboardChangeSet Changes;
+    int32 ProjectedRank = -1;
+    int32 ReconciledRank = -1;
+    if (bWasSuccessful && Parsed.IsValid())
+    {
+        Metrics.RowsParsed += Parsed->Rows.Num();
+        Metrics.ParseSeconds += Parsed->ParseSeconds;
+        INC_DWORD_STAT_BY(STAT_LeaderboardRowsParsed, Parsed->Rows.Num());
+
+        TArray<FLeaderboardRow> Rows;
+        Rows.Reserve(Parsed->Rows.Num());
+        UE_LOG(LogLeaderboard, Log, TEXT("Leaderboard data successfully read."));
+
+        // A global read of an even count comes back one rank long (see StartLeaderboardRead), only the asked-for window is kept
+        const bool bClipToWindow = !Request.bPlayers && !Request.bFriendsOnly;
+        const int32 WindowFirst = FMath::Max(Request.RankFirst, 1);
+        const int64 WindowEnd = int64(WindowFirst) + FMath::Max(Request.RankCount, 1);
+        int32 LocalRowIndex = INDEX_NONE;
+        for (int32 ParsedIndex = 0; ParsedIndex < Parsed->Rows.Num(); ++ParsedIndex)
+        {
+            FLeaderboardParsedRow& ParsedRow = Parsed->Rows[ParsedIndex];
+            if (bClipToWindow && ParsedRow.Rank > 0 && (ParsedRow.Rank < WindowFirst || ParsedRow.Rank >= WindowEnd))
+            {
+                continue;
+            }
+            if (ParsedIndex == Parsed->LocalRowIndex)
+            {
+                LocalRowIndex = Rows.Num();
+            }
+
+            FLeaderboardRow& NewRow = Rows.AddDefaulted_GetRef();
+            NewRow.Score = ParsedRow.Score;
+            NewRow.Rank = ParsedRow.Rank;
+            NewRow.NameHandle = NameTable.Intern(MoveTemp(ParsedRow.PlayerName), ParsedRow.PlayerNameHash);
+            NewRow.PlayerHandle = NameTable.Intern(MoveTemp(ParsedRow.PlayerId), ParsedRow.PlayerIdHash);
+#if LEADERBOARD_LOG_ROWS
+            UE_LOG(LogLeaderboard, Verbose, TEXT("Player: %s, Score: %d"), *NameTable.Get(NewRow.NameHandle), NewRow.Score);
+#endif
+        }
+
+        if (Request.bPlayers)
+        {
+            // Rows read by player ID stay out of the view and the query cache, they only answer lookups
+            FLeaderboardBoard* Board = Boards.Find(BoardKey);
+            if (!Board)
+            {
+                Board = &Boards.Add(BoardKey, FLeaderboardBoard(LeaderboardPageSize));
+            }
+            for (const FLeaderboardRow& Row : Rows)
+            {
+                Board->PlayersIndex.Upsert(Row);
+            }
+        }
+        else
+        {
+            // Subscriptions back off on boards that stop changing, so their reads are diffed even with nobody listening
+            const bool bDiff = OnLeaderboardRowsChanged.IsBound() || SubscriptionByRequest.Num() > 0 || bIssuingRefresh;
+            const double MergeTime = FPlatformTime::Seconds();
+            ApplyReadRows(BoardKey, Request.bFriendsOnly, Request.RankFirst, Request.RankCount, Rows, bDiff ? &Changes : nullptr, Request.LocalUserNum);
+            if (!Request.bFriendsOnly)
+            {
+                FLeaderboardBoard& Board = Boards.FindChecked(BoardKey);
+                Board.LastFetchTime = FDateTime::UtcNow();
+                Board.LastMergeTime = MergeTime;
+            }
+            if (LocalRowIndex != INDEX_NONE)
+            {
+                FLeaderboardUserState& User = Boards.FindChecked(BoardKey).GetUser(Request.LocalUserNum);
+                const FLeaderboardRow& LocalRow = Rows[LocalRowIndex];
+                User.LocalPlayerRank = LocalRow.Rank;
+                bSnapshotDirty = true;
+
+                // The backend has caught up with the local score, the projection gives way to the real rank
+                if (User.ProvisionalScore != MIN_int32 && LocalRow.Score >= User.ProvisionalScore)
+                {
+                    ReconciledRank = LocalRow.Rank;
+                    ProjectedRank = User.ProvisionalRank;
+                    User.ProvisionalScore = MIN_int32;
+                    User.ProvisionalRank = -1;
+                }
+            }
+
+            // The friends index already answers repeat friends reads, a cached copy would only replay stale rows over it
+            if (QueryCacheTTL > 0.0f && (!Request.bFriendsOnly || FriendsIndexLifetime <= 0.0f))
+            {
+                FLeaderboardCachedQuery& Cached = QueryCache.FindOrAdd(QueryKey);
+                Cached.BoardKey = BoardKey;
+                Cached.Rows = MoveTemp(Rows);
+                Cached.FetchTime = MergeTime;
+                PruneQueryCache(MergeTime);
+            }
+        }
+
+        Parsed->Rows.Reset();
+        Parsed->LocalRowIndex = INDEX_NONE;
+        if (SpareParseBuffers.Num() < 2)
+        {
+            SpareParseBuffers.Add(Parsed);
+        }
+    }
+    else
+    {
+        // Resident pages and the friends index from earlier reads stay valid
+        UE_LOG(LogLeaderboard, Warning, TEXT("Failed to read leaderboard data."));
+    }
+
+    bool bShowWindow = !Request.bDoNotShowWindow;
+    for (const FLeaderboardReadWaiter& Waiter : Request.Waiters)
+    {
+        bShowWindow |= !Waiter.bDoNotShowWindow;
+    }
+    if (bShowWindow)
+    {
+        OnLeaderboardWindowShow.Broadcast(Request.bFriendsOnly);
+    }
+    if (!Changes.IsEmpty())
+    {
+        OnLeaderboardRowsChanged.Broadcast(Request.LeaderboardName, Changes);
+    }
+    if (ReconciledRank != -1)
+    {
+        OnLeaderboardRankReconciled.Broadcast(Request.LeaderboardName, Request.LocalUserNum, ProjectedRank, ReconciledRank);
+    }
+    BroadcastQueryCompleted(Request.LeaderboardName, RequestId, bWasSuccessful);
+    for (const FLeaderboardReadWaiter& Waiter : Request.Waiters)
+    {
+        BroadcastQueryCompleted(Request.LeaderboardName, Waiter.RequestId, bWasSuccessful);
+    }
+    if (bIssuingRefresh)
+    {
+        InlineRefreshResult.Emplace(bWasSuccessful, !Changes.IsEmpty());
+    }
+    if (SubscriptionByRequest.Num() > 0)
+    {
+        const bool bChanged = !Changes.IsEmpty();
+        CompleteRefresh(RequestId, bWasSuccessful, bChanged);
+        for (const FLeaderboardReadWaiter& Waiter : Request.Waiters)
+        {
+            CompleteRefresh(Waiter.RequestId, bWasSuccessful, bChanged);
+        }
+    }
+}
+
+void ULeaderboardManager::BroadcastQueryCompleted(FName LeaderboardName, int32 RequestId, bool bWasSuccessful)
+{
+    OnLeaderBoardQueryCompleted.Broadcast(LeaderboardName, RequestId, bWasSuccessful);
+
+    if (BuildingBatchId != INDEX_NONE)
+    {
+        BuildingBatchCompletions.Add(RequestId, bWasSuccessful);
+    }
+    TPair<int32, int32> BatchSlot;
+    if (BatchSlotByRequest.RemoveAndCopyValue(RequestId, BatchSlot))
+    {
+        CompleteBatchSlot(BatchSlot.Key, BatchSlot.Value, bWasSuccessful);
+    }
+}
+
+FLeaderboardParsedReadPtr ULeaderboardManager::AcquireParseBuffer()
+{
+    if (SpareParseBuffers.Num() > 0)
+    {
+        return SpareParseBuffers.Pop(EAllowShrinking::No);
+    }
+    return MakeShared<FLeaderboardParsedRead, ESPMode::ThreadSafe>();
+}
+
+void ULeaderboardManager::OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::OnLeaderboardFlushComplete);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardFlushComplete);
+
+    double StartTime = 0.0;
+    if (FlushStartTimes.RemoveAndCopyValue(SessionName, StartTime))
+    {
+        Metrics.FlushLatency.Add(FPlatformTime::Seconds() - StartTime);
+        if (!bWasSuccessful)
+        {
+            ++Metrics.FlushesFailed;
+        }
+    }
+
+    IOnlineLeaderboardsPtr Leaderboards = GetLeaderboardsInterface();
+    FLeaderboardWriteBatch Batch;
+    WritesAwaitingFlush.RemoveAndCopyValue(SessionName, Batch);
+    if (Leaderboards.IsValid() && WritesAwaitingFlush.Num() == 0)
+    {
+        Leaderboards->ClearOnLeaderboardFlushCompleteDelegate_Handle(FlushLeaderboardDelegateHandle);
+        FlushLeaderboardDelegateHandle.Reset();
+    }
+
+    UE_LOG(LogLeaderboard, Log, TEXT("Leaderboard flush %s for session: %s"),
+        bWasSuccessful ? TEXT("succeeded") : TEXT("failed"),
+        *SessionName.ToString());
+
+    if (bWasSuccessful)
+    {
+        for (const TPair<FLeaderboardPendingWriteKey, FLeaderboardPendingWrite>& Write : Batch)
+        {
+            WriteJournal.Confirm(Write.Value.JournalSequences);
+        }
+    }
+    else
+    {
+        // Back into the queue, merged with anything submitted meanwhile; only this session's writes wait out the backoff
+        for (TPair<FLeaderboardPendingWriteKey, FLeaderboardPendingWrite>& Write : Batch)
+        {
+            RetryWrite(Write.Key, MoveTemp(Write.Value));
+        }
+    }
+
+    OnLeaderBoardFlushCompleted.Broadcast(SessionName, bWasSuccessful);
+}
+
+void ULeaderboardManager::GetMappedLeaderboardAndStat(const FString& DisplayName, FString& OutLeaderboardName, FString& OutStatName)
+{
+    if (const FLeaderboardMapping* Mapping = GetLeaderboardMapping(FindLeaderboardHandle(DisplayName)))
+    {
+        OutLeaderboardName = Mapping->LeaderboardName.ToString();
+        OutStatName = Mapping->StatName.ToString();
+    }
+}
+
+int32 ULeaderboardManager::FindLeaderboardHandle(const FString& LeaderboardName) const
+{
+    // FNAME_Find never adds to the name table, unknown strings just miss
+    const FName RowName(*LeaderboardName, FNAME_Find);
+    if (RowName.IsNone())
+    {
+        return INDEX_NONE;
+    }
+    const int32* Handle = MappingHandleByName.Find(RowName);
+    return Handle ? *Handle : INDEX_NONE;
+}
+
+const FLeaderboardMapping* ULeaderboardManager::GetLeaderboardMapping(int32 LeaderboardHandle) const
+{
+    if (!CompiledMappings.IsValidIndex(LeaderboardHandle) || CompiledMappings[LeaderboardHandle].DisplayName.IsNone())
+    {
+        return nullptr;
+    }
+    return &CompiledMappings[LeaderboardHandle];
+}
+
+void ULeaderboardManager::CompileMappingTable()
+{
+    // Existing rows keep their handle across recompiles so callers can hold on to them
+    for (FLeaderboardMapping& Mapping : CompiledMappings)
+    {
+        Mapping = FLeaderboardMapping();
+    }
+    MappingVersion = 0;
+
+    if (!LeaderboardMappingTable || !Backend.IsValid())
+    {
+        return;
+    }
+
+    // Rows are read straight from the row map, so a table of any other struct must not get past here
+    const UScriptStruct* RowStruct = LeaderboardMappingTable->GetRowStruct();
+    if (!RowStruct || !RowStruct->IsChildOf(FLeaderboardPlatformMappingRow::StaticStruct()))
+    {
+        UE_LOG(LogLeaderboard, Error, TEXT("Leaderboard mapping table %s does not use FLeaderboardPlatformMappingRow rows."), *LeaderboardMappingTable->GetPathName());
+        return;
+    }
+
+    for (const TPair<FName, uint8*>& RowPair : LeaderboardMappingTable->GetRowMap())
+    {
+        const FLeaderboardPlatformMappingRow* Row = reinterpret_cast<const FLeaderboardPlatformMappingRow*>(RowPair.Value);
+        if (!Row)
+        {
+            continue;
+        }
+
+        int32 Handle;
+        if (const int32* Existing = MappingHandleByName.Find(RowPair.Key))
+        {
+            Handle = *Existing;
+        }
+        else
+        {
+            Handle = CompiledMappings.AddDefaulted();
+            MappingHandleByName.Add(RowPair.Key, Handle);
+        }
+
+        FLeaderboardMapping& Mapping = CompiledMappings[Handle];
+        Mapping.DisplayName = RowPair.Key;
+        Mapping.ScoreGate = Row->ScoreGate;
+        Backend->ResolveMapping(*Row, RowPair.Key, Mapping);
+        Mapping.ColumnMetaData = FColumnMetaData(Mapping.StatName, EOnlineKeyValuePairDataType::Int32);
+
+        // FName hashes aren't stable between runs, the version is built from the strings
+        MappingVersion = FCrc::StrCrc32(*Mapping.DisplayName.ToString(), MappingVersion);
+        MappingVersion = FCrc::StrCrc32(*Mapping.LeaderboardName.ToString(), MappingVersion);
+        MappingVersion = FCrc::StrCrc32(*Mapping.StatName.ToString(), MappingVersion);
+    }
+}
+
+// ===== Write queue =====
+
+void ULeaderboardManager::EnqueueWrite(FName SessionName, FUniqueNetIdPtr UserId, FName LeaderboardName, FName RatedStat, FName StatName, int32 Score)
+{
+    FLeaderboardPendingWriteKey Key;
+    Key.SessionName = SessionName;
+    Key.PlayerId = UserId.IsValid() ? UserId->ToString() : FString();
+    Key.LeaderboardName = LeaderboardName;
+    Key.StatName = StatName;
+
+    FLeaderboardPendingWrite Write;
+    Write.UserId = UserId;
+    Write.RatedStat = RatedStat;
+    Write.Score = Score;
+    if (WriteJournal.IsOpen() && UserId.IsValid())
+    {
+        FLeaderboardJournalEntry Entry;
+        Entry.SessionName = SessionName;
+        Entry.UserId = UserId->ToString();
+        Entry.LeaderboardName = LeaderboardName;
+        Entry.RatedStat = RatedStat;
+        Entry.StatName = StatName;
+        Entry.Score = Score;
+        Write.JournalSequences.Add(WriteJournal.Append(Entry));
+    }
+    QueueWrite(Key, MoveTemp(Write));
+    ++Metrics.WritesQueued;
+
+    // A batch submission flushes once at its end instead of every time it crosses the threshold
+    if (!bQueueingWriteBatch && WriteFlushThreshold > 0 && PendingWrites.Num() >= WriteFlushThreshold)
+    {
+        FlushPendingWrites();
+    }
+}
+
+void ULeaderboardManager::QueueWrite(const FLeaderboardPendingWriteKey& Key, FLeaderboardPendingWrite Write)
+{
+    // Every board is written with KeepBest/Descending, so only the highest queued value can matter.
+    // The key keeps the longer backoff, a fresh score doesn't make a failing write go out sooner.
+    if (FLeaderboardPendingWrite* Existing = PendingWrites.Find(Key))
+    {
+        Existing->UserId = Write.UserId;
+        Existing->RatedStat = Write.RatedStat;
+        Existing->Score = FMath::Max(Existing->Score, Write.Score);
+        Existing->JournalSequences.Append(Write.JournalSequences);
+        Existing->Attempts = FMath::Max(Existing->Attempts, Write.Attempts);
+        Existing->NextAttemptTime = FMath::Max(Existing->NextAttemptTime, Write.NextAttemptTime);
+    }
+    else
+    {
+        PendingWrites.Add(Key, MoveTemp(Write));
+    }
+}
+
+void ULeaderboardManager::RetryWrite(const FLeaderboardPendingWriteKey& Key, FLeaderboardPendingWrite Write)
+{
+    ++Write.Attempts;
+    if (WriteMaxAttempts > 0 && Write.Attempts >= WriteMaxAttempts)
+    {
+        // Confirmed so the journal stops replaying it; a write refused this often isn't going to be accepted
+        UE_LOG(LogLeaderboard, Warning, TEXT("Giving up on leaderboard %s score %d for %s after %d attempts."),
+            *Key.LeaderboardName.ToString(), Write.Score, *Key.PlayerId, Write.Attempts);
+        WriteJournal.Confirm(Write.JournalSequences);
+        ++Metrics.WritesAbandoned;
+        return;
+    }
+
+    // Jittered so clients that lost the connection together don't all come back in the same frame
+    const float Delay = FMath::Min(WriteRetryBaseDelay * FMath::Pow(2.0f, static_cast<float>(FMath::Min(Write.Attempts - 1, 30))), WriteRetryMaxDelay);
+    Write.NextAttemptTime = FPlatformTime::Seconds() + Delay * FMath::FRandRange(0.5f, 1.0f);
+    ++Metrics.WriteRetriesScheduled;
+    UE_LOG(LogLeaderboard, Verbose, TEXT("Retrying leaderboard %s for %s in %.1f seconds."),
+        *Key.LeaderboardName.ToString(), *Key.PlayerId, Write.NextAttemptTime - FPlatformTime::Seconds());
+    QueueWrite(Key, MoveTemp(Write));
+}
+
+void ULeaderboardManager::ReplayJournal()
+{
+    IOnlineIdentityPtr Identity = GetIdentityInterface();
+    FUniqueNetIdPtr LocalUserId = Identity.IsValid() ? Identity->GetUniquePlayerId(0) : nullptr;
+    if (!Identity.IsValid() || (!LocalUserId.IsValid() && !IsRunningDedicatedServer()))
+    {
+        // Not logged in yet, the entries wait for a later tick. A dedicated server never has a local user.
+        return;
+    }
+
+    // Entries that can no longer be sent are confirmed here, otherwise they'd stay outstanding and be rewritten by
+    // every compaction
+    TSet<FName> MappedLeaderboards;
+    for (const FLeaderboardMapping& Mapping : CompiledMappings)
+    {
+        MappedLeaderboards.Add(Mapping.WriteLeaderboardName);
+    }
+    TArray<uint32> Dropped;
+
+    const FString LocalId = LocalUserId.IsValid() ? LocalUserId->ToString() : FString();
+    for (const FLeaderboardJournalEntry& Entry : JournalReplay)
+    {
+        if (!MappedLeaderboards.Contains(Entry.LeaderboardName))
+        {
+            UE_LOG(LogLeaderboard, Warning, TEXT("Dropping journaled score %d for leaderboard %s, which is no longer mapped."),
+                Entry.Score, *Entry.LeaderboardName.ToString());
+            Dropped.Add(Entry.Sequence);
+            continue;
+        }
+
+        FUniqueNetIdPtr UserId = Entry.UserId == LocalId ? LocalUserId : Identity->CreateUniquePlayerId(Entry.UserId);
+        if (!UserId.IsValid())
+        {
+            UE_LOG(LogLeaderboard, Warning, TEXT("Dropping journaled score %d for leaderboard %s, player %s can't be resolved."),
+                Entry.Score, *Entry.LeaderboardName.ToString(), *Entry.UserId);
+            Dropped.Add(Entry.Sequence);
+            continue;
+        }
+
+        FLeaderboardPendingWriteKey Key;
+        Key.SessionName = Entry.SessionName;
+        Key.PlayerId = Entry.UserId;
+        Key.LeaderboardName = Entry.LeaderboardName;
+        Key.StatName = Entry.StatName;
+
+        FLeaderboardPendingWrite Write;
+        Write.UserId = UserId;
+        Write.RatedStat = Entry.RatedStat;
+        Write.Score = Entry.Score;
+        Write.JournalSequences.Add(Entry.Sequence);
+        QueueWrite(Key, MoveTemp(Write));
+    }
+    WriteJournal.Confirm(Dropped);
+    Metrics.WritesAbandoned += Dropped.Num();
+    UE_LOG(LogLeaderboard, Log, TEXT("Replaying %d journaled leaderboard writes."), JournalReplay.Num() - Dropped.Num());
+    JournalReplay.Empty();
+}
+
+FString ULeaderboardManager::GetJournalPath() const
+{
+    return FPaths::ProjectSavedDir() / TEXT("Leaderboards") / TEXT("WriteJournal.bin");
+}
+
+bool ULeaderboardManager::TickWriteQueue(float DeltaTime)
+{
+    const double Now = FPlatformTime::Seconds();
+    if (JournalReplay.Num() > 0)
+    {
+        ReplayJournal();
+    }
+    if (PendingWrites.Num() > 0 && Now - LastWriteFlushTime >= WriteFlushInterval)
+    {
+        FlushPendingWrites();
+    }
+    if (WriteJournal.HasBufferedRecords() && Now - LastJournalSyncTime >= JournalSyncInterval)
+    {
+        WriteJournal.Sync();
+        LastJournalSyncTime = Now;
+    }
+    if (bSnapshotDirty && bPersistSnapshot && Now - LastSnapshotSaveTime >= SnapshotSaveInterval)
+    {
+        SaveLeaderboardSnapshot();
+    }
+    if (NumHeldScores > 0)
+    {
+        ReleaseHeldScores(Now);
+    }
+    if (SnapshotRefreshRanges.Num() > 0)
+    {
+        RefreshSnapshotBoards();
+    }
+    if (InFlightReads.Num() > 0)
+    {
+        ExpireStalledReads(Now);
+    }
+    if (QueryCache.Num() > 0 && Now - LastQueryCachePruneTime >= 1.0)
+    {
+        PruneQueryCache(Now);
+    }
+    if (NameTable.Num() > NameTableCompactMinimum && Now - LastNameTableCheckTime >= 1.0)
+    {
+        CompactNameTable(Now);
+    }
+    TickRefreshScheduler(Now, DeltaTime);
+    UpdateStatGauges();
+    return true;
+}
+
+void ULeaderboardManager::FlushPendingWrites()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::FlushPendingWrites);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardFlushWrites);
+
+    const double Now = FPlatformTime::Seconds();
+    LastWriteFlushTime = Now;
+    if (PendingWrites.Num() == 0)
+    {
+        return;
+    }
+
+    // Everything stays queued and journaled, the next interval tries again
+    if (!Backend.IsValid() || !Backend->CanWrite())
+    {
+        UE_LOG(LogLeaderboard, Verbose, TEXT("Leaderboard backend is not accepting writes yet, %d scores stay queued."), PendingWrites.Num());
+        return;
+    }
+    IOnlineLeaderboardsPtr Leaderboards = GetLeaderboardsInterface();
+
+    // Collapse the queue into one write object per (session, player, leaderboard) carrying all of its stats
+    TMap<FName, TMap<FLeaderboardPendingWriteKey, FLeaderboardPlayerWrite>> WritesBySession;
+    TMap<FName, FLeaderboardWriteBatch> BatchBySession;
+    for (auto It = PendingWrites.CreateIterator(); It; ++It)
+    {
+        // A session with a flush in flight keeps its new writes queued, so each completion confirms exactly what it carried.
+        // Writes still backing off stay queued too, without holding back anything else.
+        const FLeaderboardPendingWriteKey& Key = It.Key();
+        if (WritesAwaitingFlush.Contains(Key.SessionName) || It.Value().NextAttemptTime > Now)
+        {
+            continue;
+        }
+
+        FLeaderboardPendingWriteKey WriteKey = Key;
+        WriteKey.StatName = NAME_None;
+        TMap<FLeaderboardPendingWriteKey, FLeaderboardPlayerWrite>& SessionWrites = WritesBySession.FindOrAdd(Key.SessionName);
+        FLeaderboardPlayerWrite* PlayerWrite = SessionWrites.Find(WriteKey);
+        if (!PlayerWrite)
+        {
+            PlayerWrite = &SessionWrites.Add(WriteKey);
+            PlayerWrite->UserId = It.Value().UserId;
+            PlayerWrite->Write.LeaderboardNames.Add(Key.LeaderboardName);
+            PlayerWrite->Write.RatedStat = It.Value().RatedStat;
+            PlayerWrite->Write.SortMethod = ELeaderboardSort::Descending;
+            PlayerWrite->Write.UpdateMethod = ELeaderboardUpdateMethod::KeepBest;
+        }
+        PlayerWrite->Write.SetIntStat(Key.StatName, It.Value().Score);
+        BatchBySession.FindOrAdd(Key.SessionName).Emplace(Key, MoveTemp(It.Value()));
+        It.RemoveCurrent();
+    }
+
+    // However many players a session carries, it still costs a single flush
+    for (TPair<FName, TMap<FLeaderboardPendingWriteKey, FLeaderboardPlayerWrite>>& Session : WritesBySession)
+    {
+        FLeaderboardWriteBatch& Batch = BatchBySession.FindChecked(Session.Key);
+        for (TPair<FLeaderboardPendingWriteKey, FLeaderboardPlayerWrite>& Pair : Session.Value)
+        {
+            const FLeaderboardPendingWriteKey& WriteKey = Pair.Key;
+            FLeaderboardPlayerWrite& PlayerWrite = Pair.Value;
+            if (!PlayerWrite.UserId.IsValid() || !Leaderboards->WriteLeaderboards(Session.Key, *PlayerWrite.UserId, PlayerWrite.Write))
+            {
+                UE_LOG(LogLeaderboard, Warning, TEXT("Failed to write leaderboard %s."), *WriteKey.LeaderboardName.ToString());
+                ++Metrics.WritesRejectedByBackend;
+                for (int32 Index = Batch.Num() - 1; Index >= 0; --Index)
+                {
+                    if (Batch[Index].Key.LeaderboardName == WriteKey.LeaderboardName && Batch[Index].Key.PlayerId == WriteKey.PlayerId)
+                    {
+                        RetryWrite(Batch[Index].Key, MoveTemp(Batch[Index].Value));
+                        Batch.RemoveAtSwap(Index);
+                    }
+                }
+            }
+        }
+
+        if (Batch.Num() > 0)
+        {
+            if (!FlushLeaderboardDelegateHandle.IsValid())
+            {
+                FlushLeaderboardDelegateHandle = Leaderboards->AddOnLeaderboardFlushCompleteDelegate_Handle(
+                    FOnLeaderboardFlushCompleteDelegate::CreateUObject(this, &ULeaderboardManager::OnLeaderboardFlushComplete));
+            }
+            // Registered before the call, some subsystems complete the flush synchronously
+            WritesAwaitingFlush.Add(Session.Key, MoveTemp(Batch));
+            FlushStartTimes.Add(Session.Key, FPlatformTime::Seconds());
+            ++Metrics.FlushesIssued;
+            Leaderboards->FlushLeaderboards(Session.Key);
+        }
+    }
+}
+
+// ===== Refresh scheduler =====
+
+int32 ULeaderboardManager::SubscribeLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, int32 Priority, float FreshnessTarget)
+{
+    if (FindLeaderboardHandle(LeaderboardName) == INDEX_NONE)
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("Cannot subscribe to unknown leaderboard %s."), *LeaderboardName);
+        return INDEX_NONE;
+    }
+
+    const int32 SubscriptionId = NextSubscriptionId++;
+    FLeaderboardSubscription& Subscription = Subscriptions.Add(SubscriptionId);
+    Subscription.WorldName = WorldName;
+    Subscription.LeaderboardName = LeaderboardName;
+    Subscription.bFriendsOnly = bFriendsOnly;
+    Subscription.RankFirst = RankFirst;
+    Subscription.RankCount = RankCount;
+    Subscription.Priority = Priority;
+    Subscription.FreshnessTarget = FMath::Max(FreshnessTarget, 1.0f);
+    Subscription.Interval = Subscription.FreshnessTarget;
+    return SubscriptionId;
+}
+
+void ULeaderboardManager::UnsubscribeLeaderboard(int32 SubscriptionId)
+{
+    // A read still in flight completes normally, its entry in SubscriptionByRequest just finds nothing
+    Subscriptions.Remove(SubscriptionId);
+}
+
+void ULeaderboardManager::SetLeaderboardSubscriptionVisible(int32 SubscriptionId, bool bVisible)
+{
+    if (FLeaderboardSubscription* Subscription = Subscriptions.Find(SubscriptionId))
+    {
+        Subscription->bVisible = bVisible;
+    }
+}
+
+void ULeaderboardManager::TickRefreshScheduler(double Now, float DeltaTime)
+{
+    if (Subscriptions.Num() == 0)
+    {
+        RefreshBudget = 0.0;
+        return;
+    }
+
+    // Allow a burst of at most one second's worth so a long hitch doesn't release a flood of reads
+    RefreshBudget = FMath::Min(RefreshBudget + DeltaTime * RefreshRequestsPerSecond, FMath::Max(1.0, static_cast<double>(RefreshRequestsPerSecond)));
+    while (RefreshBudget >= 1.0)
+    {
+        // Highest priority first, then whichever is furthest past its due time relative to its interval
+        int32 BestId = INDEX_NONE;
+        FLeaderboardSubscription* Best = nullptr;
+        double BestOverdue = 0.0;
+        for (TPair<int32, FLeaderboardSubscription>& Pair : Subscriptions)
+        {
+            FLeaderboardSubscription& Subscription = Pair.Value;
+            if (!Subscription.bVisible || Subscription.RequestId != INDEX_NONE || Now < Subscription.NextRefreshTime)
+            {
+                continue;
+            }
+            const double Overdue = (Now - Subscription.NextRefreshTime) / FMath::Max(Subscription.Interval, 1.0f);
+            if (!Best || Subscription.Priority > Best->Priority || (Subscription.Priority == Best->Priority && Overdue > BestOverdue))
+            {
+                BestId = Pair.Key;
+                Best = &Subscription;
+                BestOverdue = Overdue;
+            }
+        }
+        if (!Best)
+        {
+            break;
+        }
+
+        RefreshBudget -= 1.0;
+        IssueRefresh(BestId, *Best);
+    }
+}
+
+void ULeaderboardManager::IssueRefresh(int32 SubscriptionId, FLeaderboardSubscription& Subscription)
+{
+    InlineRefreshResult.Reset();
+    int32 RequestId = INDEX_NONE;
+    {
+        TGuardValue<bool> IssuingRefresh(bIssuingRefresh, true);
+        RequestId = ReadLeaderboard(Subscription.WorldName, Subscription.LeaderboardName, Subscription.bFriendsOnly, Subscription.RankFirst, Subscription.RankCount, true);
+    }
+
+    if (RequestId == INDEX_NONE)
+    {
+        RescheduleRefresh(Subscription, false, false);
+    }
+    else if (IsReadInFlight(RequestId))
+    {
+        Subscription.RequestId = RequestId;
+        SubscriptionByRequest.Add(RequestId, SubscriptionId);
+    }
+    else
+    {
+        // The backend completed the read synchronously, before the request ID was known
+        const TPair<bool, bool> Result = InlineRefreshResult.Get(TPair<bool, bool>(true, false));
+        RescheduleRefresh(Subscription, Result.Key, Result.Value);
+    }
+    InlineRefreshResult.Reset();
+}
+
+void ULeaderboardManager::CompleteRefresh(int32 RequestId, bool bWasSuccessful, bool bChanged)
+{
+    int32 SubscriptionId = INDEX_NONE;
+    if (!SubscriptionByRequest.RemoveAndCopyValue(RequestId, SubscriptionId))
+    {
+        return;
+    }
+    if (FLeaderboardSubscription* Subscription = Subscriptions.Find(SubscriptionId))
+    {
+        Subscription->RequestId = INDEX_NONE;
+        RescheduleRefresh(*Subscription, bWasSuccessful, bChanged);
+    }
+}
+
+void ULeaderboardManager::RescheduleRefresh(FLeaderboardSubscription& Subscription, bool bWasSuccessful, bool bChanged)
+{
+    const float MaxInterval = FMath::Max(RefreshMaxInterval, Subscription.FreshnessTarget);
+    float Jitter = 1.0f;
+    if (!bWasSuccessful)
+    {
+        // Same jittered doubling as write retries, so a backend outage isn't hammered by every subscription at once
+        Subscription.Failures = FMath::Min(Subscription.Failures + 1, 30);
+        Subscription.Interval = FMath::Min(Subscription.FreshnessTarget * FMath::Pow(2.0f, static_cast<float>(Subscription.Failures)), MaxInterval);
+        Jitter = FMath::FRandRange(0.5f, 1.0f);
+    }
+    else
+    {
+        Subscription.Failures = 0;
+        Subscription.Interval = bChanged ? Subscription.FreshnessTarget : FMath::Min(Subscription.Interval * 1.5f, MaxInterval);
+    }
+    Subscription.NextRefreshTime = FPlatformTime::Seconds() + Subscription.Interval * Jitter;
+}
+
+// ===== Snapshot =====
+
+FString ULeaderboardManager::GetSnapshotPath() const
+{
+    return FPaths::ProjectSavedDir() / TEXT("Leaderboards") / TEXT("LeaderboardSnapshot.bin");
+}
+
+void ULeaderboardManager::SaveLeaderboardSnapshot()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE(ULeaderboardManager::SaveLeaderboardSnapshot);
+    SCOPE_CYCLE_COUNTER(STAT_LeaderboardSaveSnapshot);
+
+    if (SnapshotWriteTask.IsValid() && !SnapshotWriteTask.IsReady())
+    {
+        return;
+    }
+
+    // The image is built here since boards and the name table belong to the game thread; only the file IO moves off it
+    FLeaderboardSnapshotWriter Writer(NameTable, static_cast<uint32>(PlatformType), MappingVersion);
+    TArray<FLeaderboardRankRange> Ranges;
+    TArray<FLeaderboardRow> Rows;
+    for (const TPair<FName, FLeaderboardBoard>& Pair : Boards)
+    {
+        const FLeaderboardPagedStore& Store = Pair.Value.Store;
+        Store.GetResidentRanges(Ranges);
+        if (Ranges.Num() == 0)
+        {
+            continue;
+        }
+        Store.ToArray(Rows);
+
+        // Only the primary user's rank is persisted, split-screen guests get theirs back from the next read
+        const FLeaderboardUserState* PrimaryUser = Pair.Value.FindUser(0);
+        Writer.BeginBoard(Pair.Key.ToString(), Pair.Value.LastFetchTime, PrimaryUser ? PrimaryUser->LocalPlayerRank : -1);
+        int32 RowIndex = 0;
+        for (const FLeaderboardRankRange& Range : Ranges)
+        {
+            // The reader refuses wider ranges, so a long run of covered ranks is saved in pieces
+            for (int32 RankFirst = Range.RankFirst; RankFirst < Range.RankFirst + Range.RankCount; RankFirst += LeaderboardSnapshot::MaxRankCount)
+            {
+                const int32 RankCount = FMath::Min(Range.RankFirst + Range.RankCount - RankFirst, LeaderboardSnapshot::MaxRankCount);
+                const int32 FirstRow = RowIndex;
+                while (RowIndex < Rows.Num() && Rows[RowIndex].Rank < RankFirst + RankCount)
+                {
+                    ++RowIndex;
+                }
+                Writer.AddRange(RankFirst, RankCount, MakeArrayView(Rows.GetData() + FirstRow, RowIndex - FirstRow));
+            }
+        }
+    }
+
+    bSnapshotDirty = false;
+    LastSnapshotSaveTime = FPlatformTime::Seconds();
+    SnapshotWriteTask = Async(EAsyncExecution::ThreadPool, [Bytes = Writer.Finish(FDateTime::UtcNow()), Path = GetSnapshotPath()]()
+    {
+        // Written next to the real file and moved over it, so a crash mid-write never leaves a torn snapshot
+        const FString TempPath = Path + TEXT(".tmp");
+        if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true, true))
+        {
+            UE_LOG(LogLeaderboard, Warning, TEXT("Failed to write leaderboard snapshot %s."), *Path);
+            return false;
+        }
+        return true;
+    });
+}
+
+void ULeaderboardManager::LoadLeaderboardSnapshot()
+{
+    // A save from before a re-Initialize may still be moving the file into place
+    if (SnapshotWriteTask.IsValid())
+    {
+        SnapshotWriteTask.Wait();
+    }
+
+    FLeaderboardSnapshotReader Reader;
+    if (!Reader.Open(GetSnapshotPath()))
+    {
+        return;
+    }
+
+    const LeaderboardSnapshot::FHeader& Header = Reader.GetHeader();
+    if (Header.Platform != static_cast<uint32>(PlatformType) || Header.MappingVersion != MappingVersion)
+    {
+        UE_LOG(LogLeaderboard, Log, TEXT("Ignoring leaderboard snapshot written for another platform or mapping table."));
+        return;
+    }
+
+    // Rows are read straight out of the mapping; each distinct string is converted and interned once
+    TArray<int32> HandleByString;
+    HandleByString.Init(INDEX_NONE, Reader.NumStrings());
+    auto InternString = [&Reader, &HandleByString, this](int32 Index)
+    {
+        int32& Handle = HandleByString[Index];
+        if (Handle == INDEX_NONE)
+        {
+            Handle = NameTable.Intern(Reader.GetString(Index));
+        }
+        return Handle;
+    };
+
+    const TArrayView<const LeaderboardSnapshot::FRangeRecord> Ranges = Reader.GetRanges();
+    const TArrayView<const LeaderboardSnapshot::FRowRecord> Rows = Reader.GetRows();
+    TArray<FLeaderboardRow> RangeRows;
+    TArray<FLeaderboardRow> Dropped;
+    for (const LeaderboardSnapshot::FBoardRecord& BoardRecord : Reader.GetBoards())
+    {
+        // Boards are keyed by display name; one the mapping table no longer has would never be asked for
+        const FName BoardKey(*Reader.GetString(BoardRecord.NameString));
+        if (!MappingHandleByName.Contains(BoardKey))
+        {
+            continue;
+        }
+        FLeaderboardBoard& Board = Boards.Add(BoardKey, FLeaderboardBoard(LeaderboardPageSize));
+        Board.GetUser(0).LocalPlayerRank = BoardRecord.LocalPlayerRank;
+        Board.LastFetchTime = FDateTime(BoardRecord.FetchedAtTicks);
+
+        for (const LeaderboardSnapshot::FRangeRecord& Range : Ranges.Slice(BoardRecord.FirstRange, BoardRecord.NumRanges))
+        {
+            RangeRows.Reset(Range.NumRows);
+            for (const LeaderboardSnapshot::FRowRecord& Record : Rows.Slice(Range.FirstRow, Range.NumRows))
+            {
+                FLeaderboardRow& Row = RangeRows.AddDefaulted_GetRef();
+                Row.Score = Record.Score;
+                Row.Rank = Record.Rank;
+                Row.PlayerHandle = InternString(Record.PlayerIdString);
+                Row.NameHandle = InternString(Record.PlayerNameString);
+            }
+            Board.Store.MergeWindow(Range.RankFirst, Range.RankCount, RangeRows, Dropped);
+        }
+
+        Dropped.Reset();
+        Board.Store.EvictToBudget(MaxResidentRowsPerBoard, Dropped);
+        Board.Store.ToArray(RangeRows);
+        Board.RankIndex.Reserve(RangeRows.Num());
+        for (const FLeaderboardRow& Row : RangeRows)
+        {
+            Board.RankIndex.Upsert(Row);
+        }
+        Board.Store.GetResidentRanges(SnapshotRefreshRanges.Add(BoardKey));
+    }
+
+    // Nothing goes into the query cache, so the first read of each board still goes to the backend; the tick reads
+    // every restored range again once it can, so boards nobody asks for don't stay on old rows either
+    UE_LOG(LogLeaderboard, Log, TEXT("Restored %d leaderboards from snapshot."), Header.NumBoards);
+}
+
+void ULeaderboardManager::RefreshSnapshotBoards()
+{
+    // Global reads need the primary user signed in, which usually happens after Initialize
+    if (!Backend.IsValid() || !Backend->CanRead(0, true))
+    {
+        return;
+    }
+
+    for (const TPair<FName, TArray<FLeaderboardRankRange>>& Pair : SnapshotRefreshRanges)
+    {
+        const int32 LeaderboardHandle = FindLeaderboardHandle(Pair.Key.ToString());
+        for (const FLeaderboardRankRange& Range : Pair.Value)
+        {
+            // Merged like any other read, so listeners see what changed since the snapshot was written
+            ReadLeaderboardByHandle(FString(), LeaderboardHandle, false, Range.RankFirst, Range.RankCount, true);
+        }
+    }
+    UE_LOG(LogLeaderboard, Verbose, TEXT("Refreshing %d leaderboards restored from snapshot."), SnapshotRefreshRanges.Num());
+    SnapshotRefreshRanges.Empty();
+}
+
+// ===== Read requests =====
+
+int32 ULeaderboardManager::StartLeaderboardRead(IOnlineLeaderboardsPtr Leaderboards, FName LeaderboardName, FOnlineLeaderboardReadRef LeaderboardReadRef, const FLeaderboardReadTarget& Target, bool DoNotShowWindow)
+{
+    const int32 RequestId = NextReadRequestId++;
+
+    FLeaderboardReadRequest& Request = InFlightReads.Add(RequestId);
+    Request.RequestId = RequestId;
+    Request.LeaderboardName = LeaderboardName;
+    Request.ReadRef = LeaderboardReadRef;
+    Request.bFriendsOnly = Target.bFriendsOnly;
+    Request.bPlayers = Target.Players.Num() > 0;
+    Request.bDoNotShowWindow = DoNotShowWindow;
+    Request.LocalUserNum = Target.LocalUserNum;
+    Request.RankFirst = Target.RankFirst;
+    Request.RankCount = Target.RankCount;
+    Request.StartTime = FPlatformTime::Seconds();
+    const FLeaderboardQueryKey QueryKey = Request.GetQueryKey();
+    // Reads by player ID are not range queries, so other reads never wait on them
+    if (!Request.bPlayers)
+    {
+        InFlightQueries.Add(QueryKey, RequestId);
+    }
+    Request.DelegateHandle =
+        Leaderboards->AddOnLeaderboardReadCompleteDelegate_Handle(FOnLeaderboardReadCompleteDelegate::CreateUObject(
+            this,
+            &ULeaderboardManager::OnLeaderboardReadComplete, LeaderboardReadRef, RequestId));
+    const FDelegateHandle DelegateHandle = Request.DelegateHandle;
+
+    // Some subsystems complete synchronously, so the request may already be gone when these return
+    bool bStarted = false;
+    if (Target.Players.Num() > 0)
+    {
+        bStarted = Leaderboards->ReadLeaderboards(Target.Players, LeaderboardReadRef);
+        if (!bStarted)
+        {
+            UE_LOG(LogLeaderboard, Error, TEXT("Failed to read leaderboard for %d players."), Target.Players.Num());
+        }
+    }
+    else if (Target.bFriendsOnly)
+    {
+        bStarted = Leaderboards->ReadLeaderboardsForFriends(Target.LocalUserNum, LeaderboardReadRef);
+        if (!bStarted)
+        {
+            UE_LOG(LogLeaderboard, Error, TEXT("Failed to read friends leaderboard."));
+        }
+    }
+    else
+    {
+        // The OSS reads Range rows either side of Rank, so the window is read around its middle. An odd count is exact,
+        // an even one brings back one rank past the window, which FinishLeaderboardRead drops.
+        const int32 Radius = FMath::Max(Target.RankCount, 1) / 2;
+        bStarted = Leaderboards->ReadLeaderboardsAroundRank(FMath::Max(Target.RankFirst, 1) + Radius, Radius, LeaderboardReadRef);
+        if (!bStarted)
+        {
+            UE_LOG(LogLeaderboard, Error, TEXT("Failed to read global leaderboard."));
+        }
+    }
+
+    if (bStarted)
+    {
+        ++Metrics.ReadsIssued;
+    }
+    else
+    {
+        Leaderboards->ClearOnLeaderboardReadCompleteDelegate_Handle(DelegateHandle);
+        InFlightReads.Remove(RequestId);
+        if (InFlightQueries.FindRef(QueryKey) == RequestId)
+        {
+            InFlightQueries.Remove(QueryKey);
+        }
+        return INDEX_NONE;
+    }
+    return RequestId;
+}
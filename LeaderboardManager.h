@@ -1,112 +1,648 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "UObject/NoExportTypes.h"
-#include "OnlineError.h"
-#include "OnlineSubsystem.h"
-#include "Interfaces/OnlineLeaderboardInterface.h"
-#include "Interfaces/OnlineStatsInterface.h"
-#include "Interfaces/OnlineIdentityInterface.h"
-#include "LeaderboardManager.generated.h"
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLeaderBoardFlushCompleted, FName, SessionName, bool, bWasSuccessful);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLeaderBoardQueryCompleted, FName, SessionName, bool, bWasSuccessful);
-DECLARE_MULTICAST_DELEGATE_OneParam(FOnLeaderboardWindowShow, bool);
-
-UENUM(BlueprintType)
-enum class ELeaderboardPlatform : uint8
-{
-    Steam,
-    Epic
-};
-
-USTRUCT(BlueprintType)
-struct FLeaderboardPlatformMappingRow : public FTableRowBase
-{
-    GENERATED_BODY();
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString LeaderboardDisplayName;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString SteamLeaderboardName;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString SteamStatName;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString EpicLeaderboardName;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString EpicStatName;
-};
-
-USTRUCT(BlueprintType)
-struct FLeaderboardEntry
-{
-    GENERATED_BODY()
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    FString PlayerName;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    int32 Score;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    int32 Rank;
-
-    FLeaderboardEntry()
-        : PlayerName(TEXT("Unknown")), Score(0), Rank(0) {}
-};
-
-UCLASS()
-class YOUR_GAME_API ULeaderboardManager : public UObject
-{
-    GENERATED_BODY()
-
-public:
-    void Initialize(UDataTable* InTable);
-
-    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
-    void WriteToLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score);
-    
-    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
-    void ReadLeaderboard(const FString& WorldName, const FString& LeaderboardName,  bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
-
-    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
-    const TArray<FLeaderboardEntry>& GetLeaderboardByName(const FString& LeaderboardName) const;
-
-    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
-    void GetMappedLeaderboardAndStat(const FString& DisplayName, FString& OutLeaderboardName, FString& OutStatName);
-
-    const TMap<FString, TArray<FLeaderboardEntry>>& GetLeaderboardEntries() const;
-
-    FOnLeaderboardWindowShow OnLeaderboardWindowShow;
-
-    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
-    FOnLeaderBoardFlushCompleted OnLeaderBoardFlushCompleted;
-
-    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
-    FOnLeaderBoardQueryCompleted OnLeaderBoardQueryCompleted;
-
-private:
-    void WriteToSteamLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score);
-    void WriteToEpicLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score);
-    void ReadFromSteamLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
-    void ReadFromEpicLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
-
-    void OnLeaderboardReadComplete(bool bWasSuccessful, FOnlineLeaderboardReadRef LeaderboardReadRef);
-    void OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful);
-
-    FDelegateHandle QueryLeaderboardDelegateHandle;
-    FDelegateHandle FlushLeaderboardDelegateHandle;
-
-    TMap<FString, TArray<FLeaderboardEntry>> LeaderboardEntries;
-
-    UPROPERTY()
-    UDataTable* LeaderboardMappingTable;
-
-    bool bIsFriendLeaderboard = false;
-    bool bIsDoNotShowWindow = false;
-    ELeaderboardPlatform PlatformType = ELeaderboardPlatform::Steam;
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "OnlineError.h"
+#include "OnlineSubsystem.h"
+#include "Interfaces/OnlineLeaderboardInterface.h"
+#include "Interfaces/OnlineStatsInterface.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "LeaderboardTypes.h"
+#include "LeaderboardBackend.h"
+#include "LeaderboardRankIndex.h"
+#include "LeaderboardPagedStore.h"
+#include "LeaderboardNameTable.h"
+#include "LeaderboardWriteJournal.h"
+#include "LeaderboardMetrics.h"
+#include "LeaderboardManager.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLeaderBoardFlushCompleted, FName, SessionName, bool, bWasSuccessful);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnLeaderBoardQueryCompleted, FName, LeaderboardName, int32, RequestId, bool, bWasSuccessful);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLeaderboardBatchReadCompleted, int32, BatchId, const TArray<FLeaderboardBoardReadStatus>&, Results);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnLeaderboardRowsChanged, FName, LeaderboardName, const FLeaderboardChangeSet&, Changes);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnLeaderboardRankReconciled, FName, LeaderboardName, int32, LocalUserNum, int32, ProjectedRank, int32, ActualRank);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnLeaderboardWindowShow, bool);
+
+struct FLeaderboardQueryKey
+{
+    FName LeaderboardName;
+    bool bFriendsOnly = false;
+    int32 RankFirst = 0;
+    int32 RankCount = 0;
+    // Only friends queries differ per local user, global windows are shared by all of them
+    int32 LocalUserNum = 0;
+
+    bool operator==(const FLeaderboardQueryKey& Other) const
+    {
+        return LeaderboardName == Other.LeaderboardName && bFriendsOnly == Other.bFriendsOnly
+            && RankFirst == Other.RankFirst && RankCount == Other.RankCount && LocalUserNum == Other.LocalUserNum;
+    }
+
+    friend uint32 GetTypeHash(const FLeaderboardQueryKey& Key)
+    {
+        uint32 Hash = HashCombine(GetTypeHash(Key.LeaderboardName), GetTypeHash(Key.bFriendsOnly));
+        Hash = HashCombine(Hash, GetTypeHash(Key.LocalUserNum));
+        return HashCombine(Hash, HashCombine(GetTypeHash(Key.RankFirst), GetTypeHash(Key.RankCount)));
+    }
+};
+
+// What a read asks the backend for: a rank window or the friends of a local user, or the rows of given players.
+struct FLeaderboardReadTarget
+{
+    int32 LocalUserNum = 0;
+    bool bFriendsOnly = false;
+    int32 RankFirst = 0;
+    int32 RankCount = 0;
+    TArray<FUniqueNetIdRef> Players;
+};
+
+struct FLeaderboardCachedQuery
+{
+    FName BoardKey;
+    // Rows returned for the query's own window, merged back on a hit only if its pages were evicted since
+    TArray<FLeaderboardRow> Rows;
+    double FetchTime = 0.0;
+};
+
+// One read decoded off the game thread. Strings are hashed up front so interning them is a single lookup.
+struct FLeaderboardParsedRow
+{
+    FString PlayerName;
+    FString PlayerId;
+    uint32 PlayerNameHash = 0;
+    uint32 PlayerIdHash = 0;
+    int32 Score = 0;
+    int32 Rank = 0;
+};
+
+struct FLeaderboardParsedRead
+{
+    // Sorted by rank
+    TArray<FLeaderboardParsedRow> Rows;
+    // Row of the local player, INDEX_NONE if the read didn't include them
+    int32 LocalRowIndex = INDEX_NONE;
+    double ParseSeconds = 0.0;
+};
+
+typedef TSharedPtr<FLeaderboardParsedRead, ESPMode::ThreadSafe> FLeaderboardParsedReadPtr;
+
+// What one local user has on a board besides the shared global rows.
+struct FLeaderboardUserState
+{
+    // Friends rows with their sparse global ranks, kept apart from the pages so neither evicts the other
+    FLeaderboardRankIndex FriendsIndex;
+    bool bFriendsLoaded = false;
+    double FriendsFetchTime = 0.0;
+    // Last rank the backend reported for the user, -1 if none yet
+    int32 LocalPlayerRank = -1;
+    // Best score the user wrote that no read has returned yet, MIN_int32 if none
+    int32 ProvisionalScore = MIN_int32;
+    // Rank projected for ProvisionalScore when it was written, reported back on reconciliation
+    int32 ProvisionalRank = -1;
+};
+
+// Everything resident for one board. The FLeaderboardEntry array handed to Blueprint is only a view
+// rebuilt from the index when it's asked for after a change.
+struct FLeaderboardBoard
+{
+    FLeaderboardPagedStore Store;
+    FLeaderboardRankIndex RankIndex;
+    // Rows of players read by ID, typically on a server; sparse like friends rows and never part of the view
+    FLeaderboardRankIndex PlayersIndex;
+    // Keyed by local user index
+    TMap<int32, FLeaderboardUserState> Users;
+    // Which index the Blueprint view and lookups follow, switched by the kind of the last read
+    bool bShowingFriends = false;
+    int32 ViewUserNum = 0;
+    mutable bool bViewDirty = true;
+    // UTC time of the last global read merged into the store, or of the snapshot it was loaded from
+    FDateTime LastFetchTime;
+    // FPlatformTime of the last global read merged into the store, comparable with cached query fetch times
+    double LastMergeTime = 0.0;
+
+    explicit FLeaderboardBoard(int32 PageSize = 50)
+        : Store(PageSize) {}
+
+    const FLeaderboardUserState* FindUser(int32 LocalUserNum) const
+    {
+        return Users.Find(LocalUserNum);
+    }
+
+    FLeaderboardUserState& GetUser(int32 LocalUserNum)
+    {
+        return Users.FindOrAdd(LocalUserNum);
+    }
+
+    const FLeaderboardRankIndex& GetViewIndex() const
+    {
+        const FLeaderboardUserState* User = bShowingFriends ? FindUser(ViewUserNum) : nullptr;
+        return User ? User->FriendsIndex : RankIndex;
+    }
+};
+
+// A caller that asked for a query already in flight and is answered by that read's completion.
+struct FLeaderboardReadWaiter
+{
+    int32 RequestId = INDEX_NONE;
+    bool bDoNotShowWindow = false;
+};
+
+// Context of one outstanding read, so overlapping reads don't share flags or delegate handles.
+struct FLeaderboardReadRequest
+{
+    int32 RequestId = INDEX_NONE;
+    FName LeaderboardName;
+    FOnlineLeaderboardReadPtr ReadRef;
+    FDelegateHandle DelegateHandle;
+    bool bFriendsOnly = false;
+    // Read by player ID; neither cached nor shared with other queries
+    bool bPlayers = false;
+    bool bDoNotShowWindow = false;
+    int32 RankFirst = 0;
+    int32 RankCount = 0;
+    int32 LocalUserNum = 0;
+    double StartTime = 0.0;
+    TArray<FLeaderboardReadWaiter> Waiters;
+
+    FLeaderboardQueryKey GetQueryKey() const
+    {
+        FLeaderboardQueryKey Key;
+        Key.LeaderboardName = LeaderboardName;
+        Key.bFriendsOnly = bFriendsOnly;
+        Key.RankFirst = RankFirst;
+        Key.RankCount = RankCount;
+        Key.LocalUserNum = bFriendsOnly ? LocalUserNum : 0;
+        return Key;
+    }
+};
+
+// A ReadLeaderboards call waiting for the last of its boards.
+struct FLeaderboardReadBatch
+{
+    TArray<FLeaderboardBoardReadStatus> Results;
+    int32 NumPending = 0;
+    bool bFriendsOnly = false;
+    bool bDoNotShowWindow = false;
+};
+
+// A board kept fresh by the refresh scheduler.
+struct FLeaderboardSubscription
+{
+    FString WorldName;
+    FString LeaderboardName;
+    bool bFriendsOnly = false;
+    int32 RankFirst = 1;
+    int32 RankCount = 0;
+    int32 Priority = 0;
+    float FreshnessTarget = 30.0f;
+    bool bVisible = true;
+    // Current poll interval, stretched while the board doesn't change or reads fail, back to the target when it moves
+    float Interval = 0.0f;
+    int32 Failures = 0;
+    double NextRefreshTime = 0.0;
+    int32 RequestId = INDEX_NONE;
+};
+
+struct FLeaderboardPendingWriteKey
+{
+    FName SessionName;
+    // FUniqueNetId::ToString() of the player the score belongs to
+    FString PlayerId;
+    FName LeaderboardName;
+    FName StatName;
+
+    bool operator==(const FLeaderboardPendingWriteKey& Other) const
+    {
+        return SessionName == Other.SessionName && LeaderboardName == Other.LeaderboardName && StatName == Other.StatName
+            && PlayerId == Other.PlayerId;
+    }
+
+    friend uint32 GetTypeHash(const FLeaderboardPendingWriteKey& Key)
+    {
+        const uint32 Hash = HashCombine(HashCombine(GetTypeHash(Key.SessionName), GetTypeHash(Key.LeaderboardName)), GetTypeHash(Key.StatName));
+        return HashCombine(Hash, GetTypeHash(Key.PlayerId));
+    }
+};
+
+struct FLeaderboardPendingWrite
+{
+    FUniqueNetIdPtr UserId;
+    FName RatedStat;
+    int32 Score = 0;
+    // Journal records this write stands for, including lower scores it replaced
+    TArray<uint32> JournalSequences;
+    // Failed attempts so far, and when the next one may go out. Each key backs off on its own.
+    int32 Attempts = 0;
+    double NextAttemptTime = 0.0;
+};
+
+typedef TArray<TPair<FLeaderboardPendingWriteKey, FLeaderboardPendingWrite>> FLeaderboardWriteBatch;
+
+// What the score gate remembers about one player's accepted submissions to one board.
+struct FLeaderboardSubmitState
+{
+    int32 BestScore = MIN_int32;
+    double LastWriteTime = 0.0;
+    // Best score held back by MinWriteInterval, queued once the interval is over. MIN_int32 when there is none.
+    int32 HeldScore = MIN_int32;
+    FString HeldWorldName;
+    FUniqueNetIdPtr HeldUserId;
+    int32 HeldLocalUserNum = INDEX_NONE;
+};
+
+UCLASS()
+class YOUR_GAME_API ULeaderboardManager : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    void Initialize(UDataTable* InTable);
+
+    virtual void BeginDestroy() override;
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void WriteToLeaderboard(const FString& WorldName, const FString& LeaderboardName, int32 Score);
+
+    // Handles are stable for the lifetime of the manager, including editor hot reloads of the mapping table.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 FindLeaderboardHandle(const FString& LeaderboardName) const;
+
+    const FLeaderboardMapping* GetLeaderboardMapping(int32 LeaderboardHandle) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void WriteToLeaderboardByHandle(const FString& WorldName, int32 LeaderboardHandle, int32 Score);
+
+    // Writes for a split-screen user. WriteToLeaderboard is the same for user 0.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void WriteToLeaderboardForUser(const FString& WorldName, const FString& LeaderboardName, int32 LocalUserNum, int32 Score);
+
+    // Writes for any player by ID, e.g. from a dedicated server. No local user state is touched.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void WriteToLeaderboardForPlayer(const FString& WorldName, const FString& LeaderboardName, const FUniqueNetIdRepl& PlayerId, int32 Score);
+
+    // Queues a score per player and sends them as one batch: a write per player and a single flush for the session.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void WriteLeaderboardScores(const FString& WorldName, const FString& LeaderboardName, const TArray<FLeaderboardPlayerScore>& Scores);
+    
+    // Sends every queued score right away instead of waiting for the flush interval.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void FlushPendingWrites();
+
+    // Starts a read and returns its request ID, or INDEX_NONE if the read could not be issued.
+    // A global read returns exactly ranks RankFirst to RankFirst + RankCount - 1, fewer where the board ends; RankFirst
+    // below 1 starts at 1. A friends read ignores the range and returns every friend with a score.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadLeaderboard(const FString& WorldName, const FString& LeaderboardName,  bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadLeaderboardByHandle(const FString& WorldName, int32 LeaderboardHandle, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false, int32 LocalUserNum = 0);
+
+    // Reads as a split-screen user: their friends, and their row picked out as the local one.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadLeaderboardForUser(const FString& WorldName, const FString& LeaderboardName, int32 LocalUserNum, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
+
+    // Reads the rows of specific players into the board's players index; GetPlayerRank finds them there.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadLeaderboardForPlayers(const FString& WorldName, const FString& LeaderboardName, const TArray<FUniqueNetIdRepl>& Players, bool DoNotShowWindow = true);
+
+    // Reads every board at once and returns a batch ID. OnLeaderboardBatchReadCompleted fires once with the status of
+    // each board after the last one is in; if every board is cached that happens before this returns.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadLeaderboards(const FString& WorldName, const TArray<FString>& LeaderboardNames, bool bFriendsOnly, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    bool IsReadInFlight(int32 RequestId) const;
+
+    // Keeps a board window refreshed in the background instead of polling it from timers. Reads are spread under
+    // RefreshRequestsPerSecond, higher priorities first, and aim to be no older than FreshnessTarget seconds; boards
+    // that don't change or fail are polled less often. Returns a subscription ID, or INDEX_NONE for an unknown board.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 SubscribeLeaderboard(const FString& WorldName, const FString& LeaderboardName, bool bFriendsOnly, int32 RankFirst, int32 RankCount, int32 Priority = 0, float FreshnessTarget = 30.0f);
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void UnsubscribeLeaderboard(int32 SubscriptionId);
+
+    // Hidden subscriptions are not refreshed; once shown again an overdue board is read on the next tick.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void SetLeaderboardSubscriptionVisible(int32 SubscriptionId, bool bVisible);
+
+    // Marks every cached query of the board as stale so the next read refreshes it.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void InvalidateLeaderboardCache(const FString& LeaderboardName);
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void ClearLeaderboardCache();
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    const TArray<FLeaderboardEntry>& GetLeaderboardByName(const FString& LeaderboardName) const;
+
+    // Rows around the player in board order, Radius on each side. An empty PlayerId means local user LocalUserNum.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    TArray<FLeaderboardEntry> GetEntriesAroundPlayer(const FString& LeaderboardName, const FString& PlayerId, int32 Radius, int32 LocalUserNum = 0) const;
+
+    // Backend rank of the player in the resident rows, or -1. An empty PlayerId means local user LocalUserNum.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 GetPlayerRank(const FString& LeaderboardName, const FString& PlayerId, int32 LocalUserNum = 0) const;
+
+    // The local user's rank and neighbours, counting scores written but not read back yet. Until a read returns the
+    // score, the rank is projected from the resident rows and the result is flagged provisional.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    FLeaderboardRankProjection GetLocalRankProjection(const FString& LeaderboardName, int32 Radius, int32 LocalUserNum = 0) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    bool GetEntryAtPosition(const FString& LeaderboardName, int32 Position, FLeaderboardEntry& OutEntry) const;
+
+    // Rows from the local user's friends index, whichever view was read last. Empty until a friends read is in.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    TArray<FLeaderboardEntry> GetFriendsLeaderboard(const FString& LeaderboardName, int32 LocalUserNum = 0) const;
+
+    // 1-based place among the local user's friends, the user themself if PlayerId is empty. -1 if not in the index.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 GetFriendRank(const FString& LeaderboardName, const FString& PlayerId, int32 LocalUserNum = 0) const;
+
+    // Friends now ahead of the local user that Score would pass, best first.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    TArray<FLeaderboardEntry> GetFriendsBeatenByScore(const FString& LeaderboardName, int32 Score, int32 LocalUserNum = 0) const;
+
+    // Index rows carry name table handles, resolve them through GetNameTable(). Follows the current view.
+    // Handles are only stable until the next tick, which may compact the table once evicted rows left most of it dead.
+    const FLeaderboardRankIndex* GetRankIndex(const FString& LeaderboardName) const;
+    const FLeaderboardNameTable& GetNameTable() const;
+
+    // Rank ranges of the global board currently held in memory.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    TArray<FLeaderboardRankRange> GetResidentRanges(const FString& LeaderboardName) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    TArray<FLeaderboardRankRange> GetMissingRanges(const FString& LeaderboardName, int32 RankFirst, int32 RankCount) const;
+
+    // Keeps the pages of a visible range from being evicted first.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void MarkRangeViewed(const FString& LeaderboardName, int32 RankFirst, int32 RankCount);
+
+    // Reads only the parts of the window that aren't resident yet and returns how many reads were issued.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    int32 ReadMissingLeaderboardRanges(const FString& WorldName, const FString& LeaderboardName, int32 RankFirst, int32 RankCount, bool DoNotShowWindow = false);
+
+    // Routes every backend call through the given interfaces instead of IOnlineSubsystem::Get(). Used by the
+    // mock backend and benchmarks; pass null to go back to the live subsystem. Takes effect immediately.
+    void SetOnlineInterfacesOverride(IOnlineLeaderboardsPtr InLeaderboards, IOnlineIdentityPtr InIdentity);
+
+    // UTC time the resident rows were fetched; boards restored from disk keep the snapshot's time. Zero if unknown.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    FDateTime GetLeaderboardFetchTime(const FString& LeaderboardName) const;
+
+    // Writes the resident global boards to disk on a background thread. Skipped while a previous save is running.
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void SaveLeaderboardSnapshot();
+
+    // Counters since Initialize or the last ResetMetrics, plus current queue depths and memory use.
+    // Always collected, unlike the STAT_ counters, so it also works in shipping builds.
+    FLeaderboardMetrics GetMetrics() const;
+    void ResetMetrics();
+
+    UFUNCTION(BlueprintCallable, Category = "Leaderboard")
+    void GetMappedLeaderboardAndStat(const FString& DisplayName, FString& OutLeaderboardName, FString& OutStatName);
+
+    const TMap<FString, TArray<FLeaderboardEntry>>& GetLeaderboardEntries() const;
+
+    FOnLeaderboardWindowShow OnLeaderboardWindowShow;
+
+    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
+    FOnLeaderBoardFlushCompleted OnLeaderBoardFlushCompleted;
+
+    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
+    FOnLeaderBoardQueryCompleted OnLeaderBoardQueryCompleted;
+
+    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
+    FOnLeaderboardBatchReadCompleted OnLeaderboardBatchReadCompleted;
+
+    // A read returned a local user's provisional score. ProjectedRank is the estimate made when it was written.
+    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
+    FOnLeaderboardRankReconciled OnLeaderboardRankReconciled;
+
+    // Rows a read inserted, removed, moved or rescored, so lists can patch single rows instead of rebuilding.
+    // Fires before the query completion, and only when something changed. Nothing is diffed while unbound.
+    UPROPERTY(BlueprintAssignable, Category = "Leaderboard")
+    FOnLeaderboardRowsChanged OnLeaderboardRowsChanged;
+
+    // Seconds between automatic flushes of the write queue. Zero or less flushes on the next tick.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float WriteFlushInterval = 2.0f;
+
+    // Number of distinct queued stats that triggers an immediate flush.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 WriteFlushThreshold = 16;
+
+    // Seconds a cached query is answered from memory without touching the backend. Zero disables the cache.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float QueryCacheTTL = 30.0f;
+
+    // Seconds past the TTL a stale query is still served while it refreshes in the background.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float QueryCacheStaleLifetime = 300.0f;
+
+    // Most cached queries kept at once, the oldest are dropped past it. Zero or less removes the cap.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 MaxCachedQueries = 256;
+
+    // Seconds a read may wait for the backend before it fails, together with every identical query waiting on it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float ReadTimeout = 30.0f;
+
+    // Seconds friends reads are answered from the local friends index, which local writes keep current, before the
+    // backend is asked again. Zero sends every friends read to the backend.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float FriendsIndexLifetime = 600.0f;
+
+    // Ranks per page of the resident global board. Only applied to boards created after a change.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 LeaderboardPageSize = 50;
+
+    // Memory budget per board, least recently viewed pages are evicted past it. Zero or less disables eviction.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 MaxResidentRowsPerBoard = 5000;
+
+    // Decode and sort large reads on a task graph worker so only the merge and the broadcasts run on the game thread.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    bool bParseReadsAsync = true;
+
+    // Reads with fewer rows than this are parsed inline, where a task round trip would cost more than it saves.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 AsyncParseRowThreshold = 256;
+
+    // Keep resident boards in Saved/Leaderboards so they show on the first frame and while offline.
+    // Restored ranges are read again in the background once the backend accepts reads.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    bool bPersistSnapshot = true;
+
+    // Minimum seconds between snapshot saves after boards changed. The last state is also saved on destroy.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float SnapshotSaveInterval = 30.0f;
+
+    // Journal every submitted score to Saved/Leaderboards until a flush confirms it, and replay what's left on startup.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    bool bJournalWrites = true;
+
+    // Seconds between fsyncs of the journal. Scores submitted within the last interval can be lost to a crash.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float JournalSyncInterval = 0.5f;
+
+    // First retry delay after a failed write or flush, doubled on each further failure up to WriteRetryMaxDelay.
+    // Only the failed writes wait; other players, boards and sessions keep flushing on schedule.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float WriteRetryBaseDelay = 2.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float WriteRetryMaxDelay = 300.0f;
+
+    // Attempts before a write is given up and confirmed in the journal, so one the backend never accepts isn't
+    // retried forever. Zero or less retries without limit.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    int32 WriteMaxAttempts = 20;
+
+    // Reads the refresh scheduler may issue per second across all subscriptions. Reads made directly are not counted.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float RefreshRequestsPerSecond = 0.5f;
+
+    // Longest a subscription waits between reads while its board is unchanged or its reads keep failing.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Leaderboard")
+    float RefreshMaxInterval = 300.0f;
+
+private:
+    void WriteScore(const FString& WorldName, const FLeaderboardMapping& Mapping, FUniqueNetIdPtr UserId, int32 LocalUserNum, int32 Score);
+    bool PassesScoreGate(const FString& WorldName, const FLeaderboardMapping& Mapping, FUniqueNetIdPtr UserId, const FString& PlayerId, int32 LocalUserNum, int32 Score, double Now);
+    void ReleaseHeldScores(double Now);
+    int32 IssueLeaderboardRead(const FString& WorldName, const FLeaderboardMapping& Mapping, const FLeaderboardReadTarget& Target, bool DoNotShowWindow);
+    int32 ServeFriendsIndex(const FLeaderboardMapping& Mapping, FLeaderboardBoard& Board, int32 LocalUserNum, bool DoNotShowWindow);
+    void ShowBoardView(FName LeaderboardName, FLeaderboardBoard& Board, bool bFriendsOnly, int32 LocalUserNum);
+    void UpdateLocalFriendScore(FLeaderboardBoard& Board, int32 LocalUserNum, int32 Score);
+    int32 ServeCachedQuery(const FLeaderboardCachedQuery& Cached, const FLeaderboardQueryKey& Key, bool DoNotShowWindow);
+    void ApplyReadRows(FName BoardKey, bool bFriendsOnly, int32 RankFirst, int32 RankCount, const TArray<FLeaderboardRow>& Rows, FLeaderboardChangeSet* OutChanges = nullptr, int32 LocalUserNum = 0);
+    FLeaderboardEntry MakeEntry(const FLeaderboardRow& Row) const;
+    FLeaderboardRowChange MakeRowChange(const FLeaderboardRow* OldRow, const FLeaderboardRow* NewRow) const;
+    void AddRowChange(const FLeaderboardRow* OldRow, const FLeaderboardRow& NewRow, FLeaderboardChangeSet& OutChanges) const;
+    void DiffRows(const TArray<FLeaderboardRow>& OldRows, const TArray<FLeaderboardRow>& NewRows, FLeaderboardChangeSet& OutChanges) const;
+    void ProjectLocalRank(const FLeaderboardBoard& Board, int32 LocalUserNum, int32 Score, int32 Radius, FLeaderboardRankProjection& OutProjection) const;
+    const TArray<FLeaderboardEntry>& GetEntryView(FName BoardKey, const FLeaderboardBoard& Board) const;
+    const FLeaderboardBoard* FindBoard(const FString& LeaderboardName) const;
+    FLeaderboardBoard* FindBoard(const FString& LeaderboardName);
+    int32 StartLeaderboardRead(IOnlineLeaderboardsPtr Leaderboards, FName LeaderboardName, FOnlineLeaderboardReadRef LeaderboardReadRef, const FLeaderboardReadTarget& Target, bool DoNotShowWindow);
+
+    FString GetLocalPlayerId(int32 LocalUserNum = 0) const;
+    FUniqueNetIdPtr GetLocalUserId(int32 LocalUserNum) const;
+    IOnlineLeaderboardsPtr GetLeaderboardsInterface() const;
+    IOnlineIdentityPtr GetIdentityInterface() const;
+    void CompileMappingTable();
+    void LoadLeaderboardSnapshot();
+    void RefreshSnapshotBoards();
+    FString GetSnapshotPath() const;
+    void InvalidateCachedQueries(FName BoardName);
+    void PruneQueryCache(double Now);
+    void ExpireStalledReads(double Now);
+    // Rebuilds the name table from the handles still held by resident rows once most of it is dead
+    void CompactNameTable(double Now);
+
+    void OnLeaderboardReadComplete(bool bWasSuccessful, FOnlineLeaderboardReadRef LeaderboardReadRef, int32 RequestId);
+    void FinishLeaderboardRead(int32 RequestId, FName BoardKey, bool bWasSuccessful, FLeaderboardParsedReadPtr Parsed);
+    FLeaderboardParsedReadPtr AcquireParseBuffer();
+    void BroadcastQueryCompleted(FName LeaderboardName, int32 RequestId, bool bWasSuccessful);
+    void CompleteBatchSlot(int32 BatchId, int32 Slot, bool bWasSuccessful);
+    void OnLeaderboardFlushComplete(FName SessionName, bool bWasSuccessful);
+
+    void EnqueueWrite(FName SessionName, FUniqueNetIdPtr UserId, FName LeaderboardName, FName RatedStat, FName StatName, int32 Score);
+    void QueueWrite(const FLeaderboardPendingWriteKey& Key, FLeaderboardPendingWrite Write);
+    void RetryWrite(const FLeaderboardPendingWriteKey& Key, FLeaderboardPendingWrite Write);
+    void ReplayJournal();
+    FString GetJournalPath() const;
+    void UpdateStatGauges() const;
+    bool TickWriteQueue(float DeltaTime);
+    void TickRefreshScheduler(double Now, float DeltaTime);
+    void IssueRefresh(int32 SubscriptionId, FLeaderboardSubscription& Subscription);
+    void CompleteRefresh(int32 RequestId, bool bWasSuccessful, bool bChanged);
+    void RescheduleRefresh(FLeaderboardSubscription& Subscription, bool bWasSuccessful, bool bChanged);
+
+    FDelegateHandle FlushLeaderboardDelegateHandle;
+
+    IOnlineLeaderboardsPtr LeaderboardsOverride;
+    IOnlineIdentityPtr IdentityOverride;
+    // Chosen and bound at Initialize; holds the interfaces every read and write goes through
+    TUniquePtr<FLeaderboardBackend> Backend;
+    FTSTicker::FDelegateHandle WriteQueueTickerHandle;
+
+    // Scores waiting to be sent, collapsed per (session, player, leaderboard, stat) with KeepBest semantics.
+    TMap<FLeaderboardPendingWriteKey, FLeaderboardPendingWrite> PendingWrites;
+    // Writes handed to the backend, per session, until its flush completes. One flush per session is in flight at a time.
+    TMap<FName, FLeaderboardWriteBatch> WritesAwaitingFlush;
+    TMap<FName, double> FlushStartTimes;
+    double LastWriteFlushTime = 0.0;
+    // Set while a bulk submission queues its scores, so the flush threshold is checked once at the end
+    bool bQueueingWriteBatch = false;
+    // Board display name -> player ID -> accepted submissions, for the score gate
+    TMap<FName, TMap<FString, FLeaderboardSubmitState>> SubmitStates;
+    int32 NumHeldScores = 0;
+
+    FLeaderboardWriteJournal WriteJournal;
+    // Unconfirmed journal entries from the last run, queued again once a local user is logged in
+    TArray<FLeaderboardJournalEntry> JournalReplay;
+    double LastJournalSyncTime = 0.0;
+
+    TMap<int32, FLeaderboardReadRequest> InFlightReads;
+    TMap<FLeaderboardQueryKey, int32> InFlightQueries;
+    TMap<FLeaderboardQueryKey, FLeaderboardCachedQuery> QueryCache;
+    double LastQueryCachePruneTime = 0.0;
+    int32 NextReadRequestId = 1;
+    // Parse buffers handed back after their rows were merged; two cover one read parsing while the last one is applied
+    TArray<FLeaderboardParsedReadPtr> SpareParseBuffers;
+
+    TMap<int32, FLeaderboardReadBatch> ReadBatches;
+    // Request ID -> (batch ID, slot in the batch's results)
+    TMap<int32, TPair<int32, int32>> BatchSlotByRequest;
+    int32 NextReadBatchId = 1;
+    // Set while ReadLeaderboards fans out, to catch reads that complete before their request ID is known
+    int32 BuildingBatchId = INDEX_NONE;
+    TMap<int32, bool> BuildingBatchCompletions;
+
+    TMap<int32, FLeaderboardSubscription> Subscriptions;
+    TMap<int32, int32> SubscriptionByRequest;
+    int32 NextSubscriptionId = 1;
+    // Token bucket for scheduled reads, filled at RefreshRequestsPerSecond
+    double RefreshBudget = 0.0;
+    // Set while a scheduled read is issued, so it skips the caches and a synchronous completion is still caught
+    bool bIssuingRefresh = false;
+    // (bWasSuccessful, bChanged) of a scheduled read that completed before its request ID was known
+    TOptional<TPair<bool, bool>> InlineRefreshResult;
+
+    // Keyed by mapping display name, the same name every public call and event uses; only the read object carries the backend's
+    TMap<FName, FLeaderboardBoard> Boards;
+    FLeaderboardNameTable NameTable;
+    double LastNameTableCheckTime = 0.0;
+
+    // Compatibility view for GetLeaderboardEntries/GetLeaderboardByName, filled lazily from Boards
+    mutable TMap<FString, TArray<FLeaderboardEntry>> LeaderboardEntries;
+
+    UPROPERTY()
+    UDataTable* LeaderboardMappingTable;
+
+    // LeaderboardMappingTable resolved by the backend, indexed by leaderboard handle
+    TArray<FLeaderboardMapping> CompiledMappings;
+    TMap<FName, int32> MappingHandleByName;
+#if WITH_EDITOR
+    FDelegateHandle MappingTableChangedHandle;
+#endif
+
+    // Backend->GetPlatform(), kept for snapshots
+    ELeaderboardPlatform PlatformType = ELeaderboardPlatform::Null;
+
+    // Hash of the compiled mappings, a snapshot written under other mappings is ignored
+    uint32 MappingVersion = 0;
+    bool bSnapshotDirty = false;
+    double LastSnapshotSaveTime = 0.0;
+    TFuture<bool> SnapshotWriteTask;
+    // Ranges restored from the snapshot, read again in the background as soon as the backend accepts reads
+    TMap<FName, TArray<FLeaderboardRankRange>> SnapshotRefreshRanges;
+
+    FLeaderboardMetrics Metrics;
+};
@@ -0,0 +1,317 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardManager.h"
+#include "LeaderboardMockOnline.h"
+#include "Engine/DataTable.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/Package.h"
+
+namespace LeaderboardBenchmark
+{
+    const TCHAR* BoardName = TEXT("BenchBoard");
+    const TCHAR* StatName = TEXT("BenchScore");
+    const TCHAR* SessionName = TEXT("BenchSession");
+
+    struct FBenchmarkConfig
+    {
+        FMockLeaderboardSettings Mock;
+        int32 Iterations = 200;
+        int32 ReadWindow = 100;
+        int32 ParseWindow = 5000;
+        double TimeoutSeconds = 10.0;
+    };
+
+    struct FBenchmarkResult
+    {
+        FString Name;
+        int32 Samples = 0;
+        int32 Failures = 0;
+        double TotalSeconds = 0.0;
+        double P50 = 0.0;
+        double P99 = 0.0;
+        // Operations per second, or rows per second for the parse pass
+        double Throughput = 0.0;
+        FString ThroughputUnit;
+    };
+
+    class FSampleSet
+    {
+    public:
+        void Add(double Seconds)
+        {
+            Samples.Add(Seconds);
+            Total += Seconds;
+        }
+
+        FBenchmarkResult Finish(const FString& Name, double Units, const FString& Unit)
+        {
+            FBenchmarkResult Result;
+            Result.Name = Name;
+            Result.Samples = Samples.Num();
+            Result.TotalSeconds = Total;
+            Samples.Sort();
+            Result.P50 = Percentile(0.50);
+            Result.P99 = Percentile(0.99);
+            Result.Throughput = Total > 0.0 ? Units / Total : 0.0;
+            Result.ThroughputUnit = Unit;
+            return Result;
+        }
+
+    private:
+        double Percentile(double Fraction) const
+        {
+            if (Samples.Num() == 0)
+            {
+                return 0.0;
+            }
+            const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1);
+            return Samples[Index];
+        }
+
+        TArray<double> Samples;
+        double Total = 0.0;
+    };
+
+    double SecondsSince(uint64 StartCycles)
+    {
+        return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+    }
+
+    // Pumps the mock until Done returns true. Returns false on timeout.
+    bool PumpUntil(FMockOnlineLeaderboards& Mock, TFunctionRef<bool()> Done, double TimeoutSeconds)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!Done())
+        {
+            const double Now = FPlatformTime::Seconds();
+            if (Now > Deadline)
+            {
+                return false;
+            }
+            const int32 Delivered = Mock.ProcessPending(Now);
+            // Reads parsed on a worker are merged by a game thread task
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+            if (Delivered == 0)
+            {
+                FPlatformProcess::SleepNoStats(0.0f);
+            }
+        }
+        return true;
+    }
+
+    UDataTable* CreateMappingTable()
+    {
+        UDataTable* Table = NewObject<UDataTable>(GetTransientPackage());
+        Table->RowStruct = FLeaderboardPlatformMappingRow::StaticStruct();
+
+        // Display name matches the Steam board so writes and reads land on the same mock board
+        FLeaderboardPlatformMappingRow Row;
+        Row.LeaderboardDisplayName = BoardName;
+        Row.SteamLeaderboardName = BoardName;
+        Row.SteamStatName = StatName;
+        Row.EpicLeaderboardName = BoardName;
+        Row.EpicStatName = StatName;
+        Table->AddRow(FName(BoardName), Row);
+        return Table;
+    }
+
+    TArray<FBenchmarkResult> Run(const FBenchmarkConfig& Config)
+    {
+        TArray<FBenchmarkResult> Results;
+
+        TSharedRef<FMockOnlineIdentity, ESPMode::ThreadSafe> Identity = MakeShared<FMockOnlineIdentity, ESPMode::ThreadSafe>();
+        TSharedRef<FMockOnlineLeaderboards, ESPMode::ThreadSafe> Mock = MakeShared<FMockOnlineLeaderboards, ESPMode::ThreadSafe>(Config.Mock, Identity->GetLocalUserId());
+
+        UDataTable* Table = CreateMappingTable();
+        Table->AddToRoot();
+        ULeaderboardManager* Manager = NewObject<ULeaderboardManager>(GetTransientPackage());
+        Manager->AddToRoot();
+
+        // Every read has to reach the backend, and only explicit flushes may send writes
+        Manager->QueryCacheTTL = 0.0f;
+        Manager->FriendsIndexLifetime = 0.0f;
+        Manager->bPersistSnapshot = false;
+        Manager->bJournalWrites = false;
+        Manager->WriteFlushInterval = TNumericLimits<float>::Max();
+        Manager->WriteFlushThreshold = 0;
+        Manager->SetOnlineInterfacesOverride(Mock, Identity);
+        Manager->Initialize(Table);
+
+        const int32 Handle = Manager->FindLeaderboardHandle(BoardName);
+        const FString WorldName = SessionName;
+        FRandomStream Random(Config.Mock.Seed);
+
+        // Write enqueue: the game-thread cost of WriteToLeaderboardByHandle
+        {
+            FSampleSet Samples;
+            for (int32 Iteration = 0; Iteration < Config.Iterations; ++Iteration)
+            {
+                const uint64 Start = FPlatformTime::Cycles64();
+                Manager->WriteToLeaderboardByHandle(WorldName, Handle, Random.RandRange(0, Config.Mock.BoardSize * 10));
+                Samples.Add(SecondsSince(Start));
+            }
+            Results.Add(Samples.Finish(TEXT("Write"), Config.Iterations, TEXT("writes/s")));
+        }
+
+        // Flush: one queued score per round trip, timed until the backend confirms
+        {
+            FSampleSet Samples;
+            int32 Failures = 0;
+            for (int32 Iteration = 0; Iteration < Config.Iterations; ++Iteration)
+            {
+                Manager->WriteToLeaderboardByHandle(WorldName, Handle, Random.RandRange(0, Config.Mock.BoardSize * 10));
+                const uint64 Start = FPlatformTime::Cycles64();
+                Manager->FlushPendingWrites();
+                if (!PumpUntil(*Mock, [&Mock]() { return Mock->NumPending() == 0; }, Config.TimeoutSeconds))
+                {
+                    ++Failures;
+                }
+                Samples.Add(SecondsSince(Start));
+            }
+            FBenchmarkResult& Result = Results.Add_GetRef(Samples.Finish(TEXT("Flush"), Config.Iterations, TEXT("flushes/s")));
+            Result.Failures = Failures;
+        }
+
+        auto TimeReads = [&](const FString& Name, bool bFriendsOnly)
+        {
+            FSampleSet Samples;
+            int32 Failures = 0;
+            const int32 MaxFirst = FMath::Max(Config.Mock.BoardSize - Config.ReadWindow, 1);
+            for (int32 Iteration = 0; Iteration < Config.Iterations; ++Iteration)
+            {
+                const int32 RankFirst = bFriendsOnly ? 1 : Random.RandRange(1, MaxFirst);
+                const uint64 Start = FPlatformTime::Cycles64();
+                const int32 RequestId = Manager->ReadLeaderboardByHandle(WorldName, Handle, bFriendsOnly, RankFirst, Config.ReadWindow, true);
+                if (RequestId == INDEX_NONE || !PumpUntil(*Mock, [Manager, RequestId]() { return !Manager->IsReadInFlight(RequestId); }, Config.TimeoutSeconds))
+                {
+                    ++Failures;
+                }
+                Samples.Add(SecondsSince(Start));
+            }
+            FBenchmarkResult& Result = Results.Add_GetRef(Samples.Finish(Name, Config.Iterations, TEXT("reads/s")));
+            Result.Failures = Failures;
+        };
+        TimeReads(TEXT("ReadAroundRank"), false);
+        TimeReads(TEXT("ReadFriends"), true);
+
+        // Parse: from delivery to merged rows, plus the part of it spent on the game thread.
+        // The mock builds its rows when the read is issued, so neither sample includes it.
+        {
+            FSampleSet Samples;
+            FSampleSet GameThreadSamples;
+            int32 Failures = 0;
+            int32 RowsParsed = 0;
+            const int32 MaxFirst = FMath::Max(Config.Mock.BoardSize - Config.ParseWindow, 1);
+            const int32 ParseIterations = FMath::Max(Config.Iterations / 10, 1);
+            for (int32 Iteration = 0; Iteration < ParseIterations; ++Iteration)
+            {
+                const int32 RankFirst = Random.RandRange(1, MaxFirst);
+                const int32 RequestId = Manager->ReadLeaderboardByHandle(WorldName, Handle, false, RankFirst, Config.ParseWindow, true);
+                if (RequestId == INDEX_NONE)
+                {
+                    ++Failures;
+                    continue;
+                }
+
+                // Wait out the simulated latency without delivering anything
+                const double DueBy = FPlatformTime::Seconds() + Config.Mock.LatencySeconds + Config.Mock.LatencyJitterSeconds;
+                while (FPlatformTime::Seconds() < DueBy)
+                {
+                    FPlatformProcess::SleepNoStats(0.0f);
+                }
+
+                const uint64 Start = FPlatformTime::Cycles64();
+                Mock->ProcessPending(FPlatformTime::Seconds());
+                double GameThreadSeconds = SecondsSince(Start);
+                const double Deadline = FPlatformTime::Seconds() + Config.TimeoutSeconds;
+                while (Manager->IsReadInFlight(RequestId) && FPlatformTime::Seconds() < Deadline)
+                {
+                    const uint64 TaskStart = FPlatformTime::Cycles64();
+                    FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+                    GameThreadSeconds += SecondsSince(TaskStart);
+                }
+                Samples.Add(SecondsSince(Start));
+                GameThreadSamples.Add(GameThreadSeconds);
+
+                if (Manager->IsReadInFlight(RequestId))
+                {
+                    ++Failures;
+                }
+                else
+                {
+                    RowsParsed += Config.ParseWindow;
+                }
+            }
+            FBenchmarkResult& Result = Results.Add_GetRef(Samples.Finish(TEXT("Parse"), RowsParsed, TEXT("rows/s")));
+            Result.Failures = Failures;
+            Results.Add(GameThreadSamples.Finish(TEXT("ParseGameThread"), RowsParsed, TEXT("rows/s")));
+        }
+
+        // Flush whatever is still queued and let it land now. BeginDestroy only runs once GC gets to the manager,
+        // long after this loop stops pumping the mock, so its own final flush must find nothing left to send.
+        Manager->FlushPendingWrites();
+        PumpUntil(*Mock, [&Mock]() { return Mock->NumPending() == 0; }, Config.TimeoutSeconds);
+
+        Manager->RemoveFromRoot();
+        Manager->MarkAsGarbage();
+        Table->RemoveFromRoot();
+        Table->MarkAsGarbage();
+        return Results;
+    }
+
+    FString FormatResult(const FBenchmarkResult& Result)
+    {
+        return FString::Printf(TEXT("%-15s samples=%-5d failures=%-4d p50=%9.3fms p99=%9.3fms throughput=%.1f %s"),
+            *Result.Name, Result.Samples, Result.Failures, Result.P50 * 1000.0, Result.P99 * 1000.0, Result.Throughput, *Result.ThroughputUnit);
+    }
+
+    // Leaderboard.Benchmark [BoardSize] [Iterations] [LatencyMs] [FailureRate]
+    void RunFromConsole(const TArray<FString>& Args)
+    {
+        FBenchmarkConfig Config;
+        if (Args.Num() > 0) { Config.Mock.BoardSize = FCString::Atoi(*Args[0]); }
+        if (Args.Num() > 1) { Config.Iterations = FMath::Max(FCString::Atoi(*Args[1]), 1); }
+        if (Args.Num() > 2) { Config.Mock.LatencySeconds = FCString::Atod(*Args[2]) / 1000.0; }
+        if (Args.Num() > 3) { Config.Mock.FailureRate = FCString::Atof(*Args[3]); }
+
+        UE_LOG(LogLeaderboard, Display, TEXT("Leaderboard benchmark: board=%d iterations=%d latency=%.1fms failure=%.2f"),
+            Config.Mock.BoardSize, Config.Iterations, Config.Mock.LatencySeconds * 1000.0, Config.Mock.FailureRate);
+        for (const FBenchmarkResult& Result : Run(Config))
+        {
+            UE_LOG(LogLeaderboard, Display, TEXT("%s"), *FormatResult(Result));
+        }
+    }
+
+    FAutoConsoleCommand BenchmarkCommand(
+        TEXT("Leaderboard.Benchmark"),
+        TEXT("Runs the leaderboard manager against the mock backend. Args: [BoardSize] [Iterations] [LatencyMs] [FailureRate]"),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&RunFromConsole));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardManagerBenchmarkTest, "Game.Leaderboard.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FLeaderboardManagerBenchmarkTest::RunTest(const FString& Parameters)
+{
+    // Zero latency so the run measures the manager rather than the simulated network
+    LeaderboardBenchmark::FBenchmarkConfig Config;
+    Config.Mock.LatencySeconds = 0.0;
+    Config.Mock.LatencyJitterSeconds = 0.0;
+    Config.Mock.BoardSize = 1000000;
+
+    const TArray<LeaderboardBenchmark::FBenchmarkResult> Results = LeaderboardBenchmark::Run(Config);
+    for (const LeaderboardBenchmark::FBenchmarkResult& Result : Results)
+    {
+        AddInfo(LeaderboardBenchmark::FormatResult(Result));
+        TestEqual(*FString::Printf(TEXT("%s failures"), *Result.Name), Result.Failures, 0);
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,569 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "LeaderboardManager.h"
+#include "LeaderboardMockOnline.h"
+#include "LeaderboardNameTable.h"
+#include "LeaderboardPagedStore.h"
+#include "LeaderboardRankIndex.h"
+#include "LeaderboardSnapshot.h"
+#include "LeaderboardWriteJournal.h"
+#include "Engine/DataTable.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+namespace LeaderboardTests
+{
+    const TCHAR* BoardName = TEXT("TestBoard");
+    const TCHAR* StatName = TEXT("TestScore");
+    const TCHAR* WorldName = TEXT("TestSession");
+
+    FLeaderboardRow MakeRow(int32 PlayerHandle, int32 Score, int32 Rank = 0)
+    {
+        FLeaderboardRow Row;
+        Row.PlayerHandle = PlayerHandle;
+        Row.NameHandle = PlayerHandle;
+        Row.Score = Score;
+        Row.Rank = Rank;
+        return Row;
+    }
+
+    // Rows ranked RankFirst.. in order, player handles starting at FirstPlayer
+    TArray<FLeaderboardRow> MakeWindow(int32 RankFirst, int32 RankCount, int32 FirstPlayer)
+    {
+        TArray<FLeaderboardRow> Rows;
+        for (int32 Offset = 0; Offset < RankCount; ++Offset)
+        {
+            Rows.Add(MakeRow(FirstPlayer + Offset, 100000 - (RankFirst + Offset), RankFirst + Offset));
+        }
+        return Rows;
+    }
+
+    FString MakeTempPath(const TCHAR* FileName)
+    {
+        const FString Path = FPaths::AutomationTransientDir() / TEXT("Leaderboard") / FileName;
+        IFileManager::Get().Delete(*Path, false, true, true);
+        return Path;
+    }
+
+    // Mapping table with BoardName as its only row, rooted until the test lets it go
+    UDataTable* MakeMappingTable(const FLeaderboardScoreGate& ScoreGate)
+    {
+        UDataTable* Table = NewObject<UDataTable>(GetTransientPackage());
+        Table->RowStruct = FLeaderboardPlatformMappingRow::StaticStruct();
+        FLeaderboardPlatformMappingRow Row;
+        Row.LeaderboardDisplayName = BoardName;
+        Row.SteamLeaderboardName = BoardName;
+        Row.SteamStatName = StatName;
+        Row.EpicLeaderboardName = BoardName;
+        Row.EpicStatName = StatName;
+        Row.ScoreGate = ScoreGate;
+        Table->AddRow(FName(BoardName), Row);
+        Table->AddToRoot();
+        return Table;
+    }
+
+    bool PumpUntil(FMockOnlineLeaderboards& Mock, TFunctionRef<bool()> Done, double TimeoutSeconds = 10.0)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!Done())
+        {
+            if (FPlatformTime::Seconds() > Deadline)
+            {
+                return false;
+            }
+            Mock.ProcessPending(FPlatformTime::Seconds());
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        }
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardRankIndexTest, "Game.Leaderboard.RankIndex",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardRankIndexTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    FLeaderboardRankIndex Index;
+    Index.Upsert(MakeRow(1, 300));
+    Index.Upsert(MakeRow(2, 500));
+    Index.Upsert(MakeRow(3, 100));
+    Index.Upsert(MakeRow(4, 400));
+    Index.Upsert(MakeRow(5, 200));
+    TestEqual(TEXT("Num"), Index.Num(), 5);
+
+    // Ordered by score, best first
+    TArray<FLeaderboardRow> Rows;
+    Index.ToArray(Rows);
+    const int32 ExpectedOrder[] = { 2, 4, 1, 5, 3 };
+    for (int32 Position = 0; Position < UE_ARRAY_COUNT(ExpectedOrder); ++Position)
+    {
+        TestEqual(*FString::Printf(TEXT("Player at %d"), Position), Rows[Position].PlayerHandle, ExpectedOrder[Position]);
+        TestEqual(*FString::Printf(TEXT("Position of player %d"), ExpectedOrder[Position]), Index.GetPositionOfPlayer(ExpectedOrder[Position]), Position);
+        const FLeaderboardRow* Entry = Index.GetEntryAt(Position);
+        TestTrue(*FString::Printf(TEXT("Entry at %d"), Position), Entry && Entry->PlayerHandle == ExpectedOrder[Position]);
+    }
+    TestNull(TEXT("Entry past the end"), Index.GetEntryAt(5));
+    TestEqual(TEXT("Scores above 300"), Index.CountScoresAbove(300), 2);
+    TestEqual(TEXT("Scores above the best"), Index.CountScoresAbove(500), 0);
+    TestEqual(TEXT("Scores above the worst"), Index.CountScoresAbove(0), 5);
+
+    Index.GetEntriesAround(1, 1, Rows);
+    TestTrue(TEXT("Entries around player 1"), Rows.Num() == 3 && Rows[0].PlayerHandle == 4 && Rows[1].PlayerHandle == 1 && Rows[2].PlayerHandle == 5);
+    Index.GetEntriesAround(2, 2, Rows);
+    TestTrue(TEXT("Entries around the top player are clipped"), Rows.Num() == 3 && Rows[0].PlayerHandle == 2);
+
+    // Upserting a known player moves it instead of adding a second row
+    Index.Upsert(MakeRow(3, 600));
+    TestEqual(TEXT("Num after move"), Index.Num(), 5);
+    TestEqual(TEXT("Moved player is first"), Index.GetPositionOfPlayer(3), 0);
+    TestEqual(TEXT("Moved score"), Index.FindPlayer(3) ? Index.FindPlayer(3)->Score : 0, 600);
+
+    // Ties fall back to rank, then player handle
+    Index.Upsert(MakeRow(6, 400, 1));
+    Index.Upsert(MakeRow(7, 400, 2));
+    TestTrue(TEXT("Tied rows ordered by rank"), Index.GetPositionOfPlayer(6) < Index.GetPositionOfPlayer(7));
+
+    TestTrue(TEXT("Remove"), Index.Remove(4));
+    TestFalse(TEXT("Remove twice"), Index.Remove(4));
+    TestNull(TEXT("Removed player"), Index.FindPlayer(4));
+    TestEqual(TEXT("Position of removed player"), Index.GetPositionOfPlayer(4), INDEX_NONE);
+    TestEqual(TEXT("Num after remove"), Index.Num(), 6);
+
+    // Freed nodes are reused and the order still holds
+    Index.Upsert(MakeRow(8, 50));
+    Index.ToArray(Rows);
+    bool bOrdered = true;
+    for (int32 Position = 1; Position < Rows.Num(); ++Position)
+    {
+        bOrdered &= Rows[Position - 1].Score >= Rows[Position].Score;
+    }
+    TestTrue(TEXT("Ordered after reuse"), bOrdered);
+    TestEqual(TEXT("Last after reuse"), Rows.Last().PlayerHandle, 8);
+
+    // Compaction keeps handle order, so remapped rows keep their positions
+    FLeaderboardNameTable Names;
+    const int32 Dead = Names.Intern(TEXT("Dead"));
+    const int32 Alive = Names.Intern(TEXT("Alive"));
+    FLeaderboardRankIndex Remapped;
+    FLeaderboardRow AliveRow = MakeRow(Alive, 10);
+    Remapped.Upsert(AliveRow);
+    TBitArray<> Live(false, Names.Num());
+    Remapped.MarkHandles(Live);
+    TestFalse(TEXT("Unreferenced handle is dead"), Live[Dead]);
+    TArray<int32> Remap;
+    Names.Compact(Live, Remap);
+    Remapped.RemapHandles(Remap);
+    TestEqual(TEXT("Compacted table size"), Names.Num(), 1);
+    TestEqual(TEXT("Dropped handle"), Remap[Dead], INDEX_NONE);
+    TestEqual(TEXT("Remapped name"), Names.Get(Remap[Alive]), FString(TEXT("Alive")));
+    TestNotNull(TEXT("Remapped row"), Remapped.FindPlayer(Remap[Alive]));
+    TestEqual(TEXT("Find after compaction"), Names.Find(TEXT("Alive")), Remap[Alive]);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardPagedStoreTest, "Game.Leaderboard.PagedStore",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardPagedStoreTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    FLeaderboardPagedStore Store(10);
+    TArray<FLeaderboardRow> Removed;
+    Store.MergeWindow(1, 10, MakeWindow(1, 10, 100), Removed);
+    TestEqual(TEXT("Rows after first window"), Store.NumRows(), 10);
+    TestTrue(TEXT("First window resident"), Store.IsRangeResident(1, 10));
+    TestTrue(TEXT("Nothing removed"), Removed.Num() == 0);
+
+    // Re-reading the window replaces it; a player who left and wasn't seen elsewhere is reported
+    TArray<FLeaderboardRow> Window = MakeWindow(1, 10, 100);
+    Window[3].PlayerHandle = 500;
+    Store.MergeWindow(1, 10, Window, Removed);
+    TestTrue(TEXT("Player who left the window is removed"), Removed.Num() == 1 && Removed[0].PlayerHandle == 103);
+    TestEqual(TEXT("Rows after re-read"), Store.NumRows(), 10);
+
+    // A player showing up in another window vacates its old slot, which is no longer vouched for
+    Removed.Reset();
+    TArray<FLeaderboardRow> Lower = MakeWindow(21, 10, 200);
+    Lower[4].PlayerHandle = 105;
+    Store.MergeWindow(21, 10, Lower, Removed);
+    TestTrue(TEXT("Moved player is not removed"), Removed.Num() == 0);
+    TestFalse(TEXT("Old slot no longer resident"), Store.IsRangeResident(1, 10));
+    TArray<FLeaderboardRankRange> Missing;
+    Store.GetMissingRanges(1, 10, Missing);
+    TestTrue(TEXT("Only the vacated rank is missing"), Missing.Num() == 1 && Missing[0].RankFirst == 6 && Missing[0].RankCount == 1);
+    Store.GetMissingRanges(1, 30, Missing);
+    TestTrue(TEXT("Unread ranks are missing"), Missing.Num() == 2 && Missing[1].RankFirst == 11 && Missing[1].RankCount == 10);
+
+    // Rows beyond the asked-for window widen it
+    Removed.Reset();
+    Store.MergeWindow(41, 2, MakeWindow(41, 3, 300), Removed);
+    TestTrue(TEXT("Window widened to the returned rows"), Store.IsRangeResident(41, 3));
+
+    TArray<FLeaderboardRankRange> Resident;
+    Store.GetResidentRanges(Resident);
+    TestEqual(TEXT("Resident range count"), Resident.Num(), 4);
+
+    // The least recently viewed page goes first, the most recent one always stays
+    FPlatformProcess::Sleep(0.01f);
+    Store.Touch(21, 10);
+    FPlatformProcess::Sleep(0.01f);
+    Store.Touch(41, 3);
+    TArray<FLeaderboardRow> Evicted;
+    Store.EvictToBudget(13, Evicted);
+    TestEqual(TEXT("Rows within budget"), Store.NumRows(), 13);
+    TestEqual(TEXT("Oldest page evicted"), Evicted.Num(), 9);
+    TestTrue(TEXT("Touched page kept"), Store.IsRangeResident(21, 10));
+    TestFalse(TEXT("Evicted page not resident"), Store.IsRangeResident(1, 1));
+
+    Evicted.Reset();
+    Store.EvictToBudget(1, Evicted);
+    TestTrue(TEXT("Most recent page survives any budget"), Store.IsRangeResident(41, 3));
+
+    TArray<FLeaderboardRow> Rows;
+    Store.ToArray(Rows);
+    TestTrue(TEXT("Rows in rank order"), Rows.Num() == 3 && Rows[0].Rank == 41 && Rows[2].Rank == 43);
+
+    // Two rows on the same rank: the later one keeps the slot and the one it replaced is reported
+    Removed.Reset();
+    TArray<FLeaderboardRow> Tied = MakeWindow(41, 3, 300);
+    Tied[1].Rank = 41;
+    Store.MergeWindow(41, 3, Tied, Removed);
+    TestTrue(TEXT("Overwritten tied row removed"), Removed.Num() == 1 && Removed[0].PlayerHandle == 300);
+    Store.ToArray(Rows);
+    TestTrue(TEXT("Tied window keeps one row per player"), Rows.Num() == 2 && Rows[0].PlayerHandle == 301 && Rows[1].PlayerHandle == 302);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardSnapshotTest, "Game.Leaderboard.Snapshot",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardSnapshotTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    FLeaderboardNameTable Names;
+    TArray<FLeaderboardRow> Rows;
+    for (int32 Rank = 1; Rank <= 3; ++Rank)
+    {
+        FLeaderboardRow& Row = Rows.Add_GetRef(MakeRow(Names.Intern(FString::Printf(TEXT("Player%d"), Rank)), 1000 - Rank, Rank));
+        Row.NameHandle = Names.Intern(FString::Printf(TEXT("Name%d"), Rank));
+    }
+
+    FLeaderboardSnapshotWriter Writer(Names, 7, 42);
+    Writer.BeginBoard(BoardName, FDateTime(2024, 1, 1), 2);
+    Writer.AddRange(1, 5, Rows);
+    const TArray<uint8> Image = Writer.Finish(FDateTime::UtcNow());
+
+    const FString Path = MakeTempPath(TEXT("Snapshot.bin"));
+    TestTrue(TEXT("Snapshot saved"), FFileHelper::SaveArrayToFile(Image, *Path));
+    {
+        FLeaderboardSnapshotReader Reader;
+        if (TestTrue(TEXT("Valid snapshot opens"), Reader.Open(Path)))
+        {
+            TestTrue(TEXT("Platform"), Reader.GetHeader().Platform == 7u);
+            TestTrue(TEXT("Mapping version"), Reader.GetHeader().MappingVersion == 42u);
+            TestEqual(TEXT("Boards"), Reader.GetBoards().Num(), 1);
+            TestEqual(TEXT("Board name"), Reader.GetString(Reader.GetBoards()[0].NameString), FString(BoardName));
+            TestEqual(TEXT("Local rank"), Reader.GetBoards()[0].LocalPlayerRank, 2);
+            TestTrue(TEXT("Range"), Reader.GetRanges().Num() == 1 && Reader.GetRanges()[0].RankFirst == 1 && Reader.GetRanges()[0].RankCount == 5);
+            if (TestEqual(TEXT("Rows"), Reader.GetRows().Num(), 3))
+            {
+                const LeaderboardSnapshot::FRowRecord& Row = Reader.GetRows()[1];
+                TestEqual(TEXT("Row score"), Row.Score, 998);
+                TestEqual(TEXT("Row player"), Reader.GetString(Row.PlayerIdString), FString(TEXT("Player2")));
+                TestEqual(TEXT("Row name"), Reader.GetString(Row.PlayerNameString), FString(TEXT("Name2")));
+            }
+        }
+    }
+
+    // Corruptions below the header are resealed with a fresh CRC, so each one reaches the check it is aimed at
+    auto ExpectRejected = [this, &Image, &Path](const TCHAR* What, TFunctionRef<void(TArray<uint8>&)> Corrupt, bool bResealCrc = true)
+    {
+        TArray<uint8> Bytes = Image;
+        Corrupt(Bytes);
+        if (bResealCrc && Bytes.Num() >= static_cast<int32>(sizeof(LeaderboardSnapshot::FHeader)))
+        {
+            reinterpret_cast<LeaderboardSnapshot::FHeader*>(Bytes.GetData())->PayloadCrc =
+                FCrc::MemCrc32(Bytes.GetData() + sizeof(LeaderboardSnapshot::FHeader), Bytes.Num() - sizeof(LeaderboardSnapshot::FHeader));
+        }
+        FFileHelper::SaveArrayToFile(Bytes, *Path);
+        FLeaderboardSnapshotReader Reader;
+        TestFalse(What, Reader.Open(Path));
+    };
+    auto GetRange = [](TArray<uint8>& Bytes)
+    {
+        const LeaderboardSnapshot::FHeader& Header = *reinterpret_cast<const LeaderboardSnapshot::FHeader*>(Bytes.GetData());
+        const int64 RangesOffset = sizeof(LeaderboardSnapshot::FHeader) + Header.NumBoards * sizeof(LeaderboardSnapshot::FBoardRecord);
+        return reinterpret_cast<LeaderboardSnapshot::FRangeRecord*>(Bytes.GetData() + RangesOffset);
+    };
+    auto GetRow = [](TArray<uint8>& Bytes)
+    {
+        const LeaderboardSnapshot::FHeader& Header = *reinterpret_cast<const LeaderboardSnapshot::FHeader*>(Bytes.GetData());
+        const int64 RowsOffset = sizeof(LeaderboardSnapshot::FHeader) + Header.NumBoards * sizeof(LeaderboardSnapshot::FBoardRecord)
+            + Header.NumRanges * sizeof(LeaderboardSnapshot::FRangeRecord);
+        return reinterpret_cast<LeaderboardSnapshot::FRowRecord*>(Bytes.GetData() + RowsOffset);
+    };
+
+    ExpectRejected(TEXT("Truncated snapshot"), [](TArray<uint8>& Bytes) { Bytes.SetNum(Bytes.Num() - 1); });
+    ExpectRejected(TEXT("Snapshot with trailing bytes"), [](TArray<uint8>& Bytes) { Bytes.Add(0); });
+    ExpectRejected(TEXT("Snapshot shorter than its header"), [](TArray<uint8>& Bytes) { Bytes.SetNum(sizeof(LeaderboardSnapshot::FHeader) - 1); });
+    ExpectRejected(TEXT("Snapshot with a bad magic"), [](TArray<uint8>& Bytes)
+    {
+        reinterpret_cast<LeaderboardSnapshot::FHeader*>(Bytes.GetData())->Magic ^= 1;
+    });
+    ExpectRejected(TEXT("Snapshot from another version"), [](TArray<uint8>& Bytes)
+    {
+        ++reinterpret_cast<LeaderboardSnapshot::FHeader*>(Bytes.GetData())->Version;
+    });
+    ExpectRejected(TEXT("Snapshot with a damaged payload"), [](TArray<uint8>& Bytes) { Bytes.Last() ^= 0xFF; }, false);
+    ExpectRejected(TEXT("Snapshot with a row pointing past the strings"), [&GetRow](TArray<uint8>& Bytes)
+    {
+        GetRow(Bytes)->PlayerIdString = reinterpret_cast<const LeaderboardSnapshot::FHeader*>(Bytes.GetData())->NumStrings;
+    });
+    ExpectRejected(TEXT("Snapshot with a range pointing past the rows"), [&GetRange](TArray<uint8>& Bytes)
+    {
+        GetRange(Bytes)->NumRows = reinterpret_cast<const LeaderboardSnapshot::FHeader*>(Bytes.GetData())->NumRows + 1;
+    });
+    ExpectRejected(TEXT("Snapshot with a range before rank 1"), [&GetRange](TArray<uint8>& Bytes) { GetRange(Bytes)->RankFirst = 0; });
+    ExpectRejected(TEXT("Snapshot with an oversized range"), [&GetRange](TArray<uint8>& Bytes)
+    {
+        GetRange(Bytes)->RankCount = LeaderboardSnapshot::MaxRankCount + 1;
+    });
+    ExpectRejected(TEXT("Snapshot with a row outside its range"), [&GetRow](TArray<uint8>& Bytes) { GetRow(Bytes)->Rank = 6; });
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardWriteJournalTest, "Game.Leaderboard.WriteJournal",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardWriteJournalTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    const FString Path = MakeTempPath(TEXT("WriteJournal.bin"));
+    auto MakeEntry = [](const TCHAR* UserId, int32 Score)
+    {
+        FLeaderboardJournalEntry Entry;
+        Entry.SessionName = WorldName;
+        Entry.UserId = UserId;
+        Entry.LeaderboardName = BoardName;
+        Entry.RatedStat = StatName;
+        Entry.StatName = StatName;
+        Entry.Score = Score;
+        return Entry;
+    };
+
+    TArray<FLeaderboardJournalEntry> Outstanding;
+    uint32 ConfirmedSequence = 0;
+    {
+        FLeaderboardWriteJournal Journal;
+        TestTrue(TEXT("Empty journal opens"), Journal.Open(Path, Outstanding));
+        TestEqual(TEXT("Nothing to replay"), Outstanding.Num(), 0);
+
+        Journal.Append(MakeEntry(TEXT("A"), 10));
+        ConfirmedSequence = Journal.Append(MakeEntry(TEXT("B"), 20));
+        Journal.Append(MakeEntry(TEXT("C"), 30));
+        const uint32 Confirmed[] = { ConfirmedSequence };
+        Journal.Confirm(Confirmed);
+        TestEqual(TEXT("Outstanding after confirm"), Journal.NumOutstanding(), 2);
+        Journal.Close();
+    }
+
+    // Replay: only unconfirmed submissions come back, in submission order and intact
+    {
+        FLeaderboardWriteJournal Journal;
+        TestTrue(TEXT("Journal reopens"), Journal.Open(Path, Outstanding));
+        if (TestEqual(TEXT("Replayed submissions"), Outstanding.Num(), 2))
+        {
+            TestEqual(TEXT("First replayed user"), Outstanding[0].UserId, FString(TEXT("A")));
+            TestEqual(TEXT("Second replayed user"), Outstanding[1].UserId, FString(TEXT("C")));
+            TestTrue(TEXT("Replayed in order"), Outstanding[0].Sequence < Outstanding[1].Sequence);
+            TestEqual(TEXT("Replayed score"), Outstanding[1].Score, 30);
+            TestTrue(TEXT("Replayed board"), Outstanding[1].LeaderboardName == FName(BoardName));
+            TestTrue(TEXT("Replayed session"), Outstanding[1].SessionName == FName(WorldName));
+        }
+
+        // Sequences keep counting past everything already in the file
+        TestTrue(TEXT("New sequence after replay"), Journal.Append(MakeEntry(TEXT("D"), 40)) > Outstanding.Last().Sequence);
+        Journal.Close();
+    }
+
+    // A torn or corrupt tail is dropped and everything before it survives
+    TArray<uint8> Bytes;
+    TestTrue(TEXT("Journal written"), FFileHelper::LoadFileToArray(Bytes, *Path));
+    const int32 ValidSize = Bytes.Num();
+    Bytes.Append({ 0x20, 0x00, 0x00, 0x00, 0xDE, 0xAD });
+    FFileHelper::SaveArrayToFile(Bytes, *Path);
+    {
+        FLeaderboardWriteJournal Journal;
+        TestTrue(TEXT("Journal with a torn tail opens"), Journal.Open(Path, Outstanding));
+        TestEqual(TEXT("Submissions before the torn tail"), Outstanding.Num(), 3);
+        Journal.Close();
+    }
+
+    // A record whose checksum doesn't match ends the replay there
+    TestTrue(TEXT("Compacted journal written"), FFileHelper::LoadFileToArray(Bytes, *Path));
+    TestTrue(TEXT("Torn tail removed on the next sync"), Bytes.Num() <= ValidSize);
+    if (Bytes.Num() > 8)
+    {
+        Bytes.Last() ^= 0xFF;
+        FFileHelper::SaveArrayToFile(Bytes, *Path);
+        FLeaderboardWriteJournal Journal;
+        TestTrue(TEXT("Journal with a corrupt record opens"), Journal.Open(Path, Outstanding));
+        TestEqual(TEXT("Corrupt last record dropped"), Outstanding.Num(), 2);
+        Journal.Close();
+    }
+
+    IFileManager::Get().Delete(*Path);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardWriteRetryTest, "Game.Leaderboard.WriteRetry",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardWriteRetryTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    // Every write is refused
+    FMockLeaderboardSettings Settings;
+    Settings.LatencySeconds = 0.0;
+    Settings.LatencyJitterSeconds = 0.0;
+    Settings.BoardSize = 1000;
+    Settings.FailureRate = 1.0f;
+
+    TSharedRef<FMockOnlineIdentity, ESPMode::ThreadSafe> Identity = MakeShared<FMockOnlineIdentity, ESPMode::ThreadSafe>();
+    TSharedRef<FMockOnlineLeaderboards, ESPMode::ThreadSafe> Mock = MakeShared<FMockOnlineLeaderboards, ESPMode::ThreadSafe>(Settings, Identity->GetLocalUserId());
+    UDataTable* Table = MakeMappingTable(FLeaderboardScoreGate());
+
+    ULeaderboardManager* Manager = NewObject<ULeaderboardManager>(GetTransientPackage());
+    Manager->AddToRoot();
+    Manager->bPersistSnapshot = false;
+    Manager->bJournalWrites = false;
+    Manager->WriteFlushInterval = TNumericLimits<float>::Max();
+    Manager->WriteFlushThreshold = 0;
+    Manager->WriteRetryBaseDelay = 0.0f;
+    Manager->WriteMaxAttempts = 2;
+    Manager->SetOnlineInterfacesOverride(Mock, Identity);
+    Manager->Initialize(Table);
+
+    // A write refused WriteMaxAttempts times is given up instead of being queued again
+    Manager->WriteToLeaderboard(WorldName, BoardName, 100);
+    Manager->FlushPendingWrites();
+    TestEqual(TEXT("Refused write scheduled for a retry"), Manager->GetMetrics().WriteRetriesScheduled, int64(1));
+    TestEqual(TEXT("Refused write still queued"), Manager->GetMetrics().PendingWrites, 1);
+    Manager->FlushPendingWrites();
+    TestEqual(TEXT("Write abandoned at the attempt cap"), Manager->GetMetrics().WritesAbandoned, int64(1));
+    TestEqual(TEXT("Abandoned write dropped"), Manager->GetMetrics().PendingWrites, 0);
+
+    // A write backing off waits on its own; another session's write still goes out
+    Manager->WriteRetryBaseDelay = 60.0f;
+    Manager->WriteToLeaderboard(WorldName, BoardName, 200);
+    Manager->FlushPendingWrites();
+    const int32 WritesBefore = Mock->GetNumWrites();
+    Manager->FlushPendingWrites();
+    TestEqual(TEXT("Write inside its backoff not sent"), Mock->GetNumWrites(), WritesBefore);
+    Manager->WriteToLeaderboard(TEXT("OtherSession"), BoardName, 300);
+    Manager->FlushPendingWrites();
+    TestEqual(TEXT("Other session's write sent"), Mock->GetNumWrites(), WritesBefore + 1);
+    TestEqual(TEXT("Both writes queued for a retry"), Manager->GetMetrics().PendingWrites, 2);
+
+    Manager->RemoveFromRoot();
+    Manager->MarkAsGarbage();
+    Table->RemoveFromRoot();
+    Table->MarkAsGarbage();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLeaderboardScoreGateTest, "Game.Leaderboard.ScoreGate",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FLeaderboardScoreGateTest::RunTest(const FString& Parameters)
+{
+    using namespace LeaderboardTests;
+
+    FMockLeaderboardSettings Settings;
+    Settings.LatencySeconds = 0.0;
+    Settings.LatencyJitterSeconds = 0.0;
+    Settings.BoardSize = 1000;
+
+    TSharedRef<FMockOnlineIdentity, ESPMode::ThreadSafe> Identity = MakeShared<FMockOnlineIdentity, ESPMode::ThreadSafe>();
+    TSharedRef<FMockOnlineLeaderboards, ESPMode::ThreadSafe> Mock = MakeShared<FMockOnlineLeaderboards, ESPMode::ThreadSafe>(Settings, Identity->GetLocalUserId());
+
+    const float MinWriteInterval = 0.2f;
+    FLeaderboardScoreGate ScoreGate;
+    ScoreGate.bLimitScore = true;
+    ScoreGate.MinScore = 0;
+    ScoreGate.MaxScore = 1000000;
+    ScoreGate.bDropNonImprovingScores = true;
+    ScoreGate.MinWriteInterval = MinWriteInterval;
+    UDataTable* Table = MakeMappingTable(ScoreGate);
+
+    ULeaderboardManager* Manager = NewObject<ULeaderboardManager>(GetTransientPackage());
+    Manager->AddToRoot();
+    Manager->bPersistSnapshot = false;
+    Manager->bJournalWrites = false;
+    Manager->WriteFlushInterval = TNumericLimits<float>::Max();
+    Manager->WriteFlushThreshold = 0;
+    Manager->SetOnlineInterfacesOverride(Mock, Identity);
+    Manager->Initialize(Table);
+
+    // Range
+    Manager->WriteToLeaderboard(WorldName, BoardName, -1);
+    Manager->WriteToLeaderboard(WorldName, BoardName, 1000001);
+    TestEqual(TEXT("Out of range scores rejected"), Manager->GetMetrics().WritesRejectedOutOfRange, int64(2));
+    TestEqual(TEXT("Nothing queued for out of range scores"), Manager->GetMetrics().WritesQueued, int64(0));
+
+    // Non-improving, against the best queued and the best held back
+    Manager->WriteToLeaderboard(WorldName, BoardName, 20000);
+    TestEqual(TEXT("First score queued"), Manager->GetMetrics().WritesQueued, int64(1));
+    Manager->WriteToLeaderboard(WorldName, BoardName, 19000);
+    TestEqual(TEXT("Lower score dropped"), Manager->GetMetrics().WritesRejectedNotImproving, int64(1));
+
+    // Throttle: scores inside the interval are held, and only the best of them is queued afterwards
+    Manager->WriteToLeaderboard(WorldName, BoardName, 20200);
+    Manager->WriteToLeaderboard(WorldName, BoardName, 20100);
+    Manager->WriteToLeaderboard(WorldName, BoardName, 20300);
+    const FLeaderboardMetrics Held = Manager->GetMetrics();
+    TestEqual(TEXT("Improving scores inside the interval held"), Held.WritesThrottled, int64(2));
+    TestEqual(TEXT("Score below the held one dropped"), Held.WritesRejectedNotImproving, int64(2));
+    TestEqual(TEXT("Held scores not queued yet"), Held.WritesQueued, int64(1));
+
+    FPlatformProcess::Sleep(MinWriteInterval + 0.05f);
+    FTSTicker::GetCoreTicker().Tick(MinWriteInterval + 0.05f);
+    TestEqual(TEXT("Held score queued once the interval is over"), Manager->GetMetrics().WritesQueued, int64(2));
+
+    // The board ends up with the best held score, not the last one submitted
+    Manager->FlushPendingWrites();
+    TestTrue(TEXT("Flush completes"), PumpUntil(*Mock, [&Mock]() { return Mock->NumPending() == 0; }));
+    const int32 RequestId = Manager->ReadLeaderboard(WorldName, BoardName, false, 1, 1, true);
+    TestTrue(TEXT("Read completes"), RequestId != INDEX_NONE && PumpUntil(*Mock, [Manager, RequestId]() { return !Manager->IsReadInFlight(RequestId); }));
+    const TArray<FLeaderboardEntry>& Entries = Manager->GetLeaderboardByName(BoardName);
+    if (TestTrue(TEXT("Top row read"), Entries.Num() > 0))
+    {
+        TestEqual(TEXT("Top player"), Entries[0].PlayerId, Identity->GetLocalUserId()->ToString());
+        TestEqual(TEXT("Top score"), Entries[0].Score, 20300);
+    }
+
+    Manager->RemoveFromRoot();
+    Manager->MarkAsGarbage();
+    Table->RemoveFromRoot();
+    Table->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
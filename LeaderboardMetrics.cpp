@@ -0,0 +1,65 @@
+#include "LeaderboardMetrics.h"
+
+void FLeaderboardLatencyHistogram::Add(double Seconds)
+{
+    const double Milliseconds = Seconds * 1000.0;
+    int32 Bucket = 0;
+    if (Milliseconds >= 1.0)
+    {
+        Bucket = FMath::Min(FMath::FloorLog2(static_cast<uint32>(FMath::Min(Milliseconds, double(MAX_uint32)))) + 1, NumBuckets - 1);
+    }
+    ++Buckets[Bucket];
+    ++Count;
+    TotalSeconds += Seconds;
+    MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+}
+
+double FLeaderboardLatencyHistogram::GetPercentileSeconds(double Fraction) const
+{
+    if (Count == 0)
+    {
+        return 0.0;
+    }
+
+    const uint32 Target = FMath::Max<uint32>(FMath::CeilToInt(Fraction * Count), 1);
+    uint32 Seen = 0;
+    for (int32 Bucket = 0; Bucket < NumBuckets - 1; ++Bucket)
+    {
+        Seen += Buckets[Bucket];
+        if (Seen >= Target)
+        {
+            return FMath::Min(double(1u << Bucket) / 1000.0, MaxSeconds);
+        }
+    }
+    return MaxSeconds;
+}
+
+double FLeaderboardMetrics::GetCacheHitRate() const
+{
+    const int64 Lookups = CacheHits + CacheStaleHits + CacheMisses;
+    return Lookups > 0 ? double(CacheHits + CacheStaleHits) / Lookups : 0.0;
+}
+
+FString FLeaderboardMetrics::ToString() const
+{
+    FString Out;
+    Out += FString::Printf(TEXT("Reads: issued=%lld ok=%lld failed=%lld timed-out=%lld in-flight=%d deduplicated=%lld\n"),
+        ReadsIssued, ReadsSucceeded, ReadsFailed, ReadsTimedOut, InFlightReads, ReadsDeduplicated);
+    Out += FString::Printf(TEXT("Cache: hits=%lld stale=%lld misses=%lld hit-rate=%.1f%%\n"),
+        CacheHits, CacheStaleHits, CacheMisses, GetCacheHitRate() * 100.0);
+    Out += FString::Printf(TEXT("Read latency: n=%u avg=%.1fms p50<=%.0fms p99<=%.0fms max=%.1fms\n"),
+        ReadLatency.Count, ReadLatency.GetAverageSeconds() * 1000.0, ReadLatency.GetPercentileSeconds(0.5) * 1000.0,
+        ReadLatency.GetPercentileSeconds(0.99) * 1000.0, ReadLatency.MaxSeconds * 1000.0);
+    Out += FString::Printf(TEXT("Parse: rows=%lld rows/s=%.0f\n"), RowsParsed, GetRowsParsedPerSecond());
+    Out += FString::Printf(TEXT("Writes: queued=%lld pending=%d rejected=%lld retries=%lld abandoned=%lld journal=%d\n"),
+        WritesQueued, PendingWrites, WritesRejectedByBackend, WriteRetriesScheduled, WritesAbandoned, JournalOutstanding);
+    Out += FString::Printf(TEXT("Score gate: out-of-range=%lld throttled=%lld not-improving=%lld\n"),
+        WritesRejectedOutOfRange, WritesThrottled, WritesRejectedNotImproving);
+    Out += FString::Printf(TEXT("Flushes: issued=%lld failed=%lld awaiting=%d\n"), FlushesIssued, FlushesFailed, SessionsAwaitingFlush);
+    Out += FString::Printf(TEXT("Flush latency: n=%u avg=%.1fms p50<=%.0fms p99<=%.0fms max=%.1fms\n"),
+        FlushLatency.Count, FlushLatency.GetAverageSeconds() * 1000.0, FlushLatency.GetPercentileSeconds(0.5) * 1000.0,
+        FlushLatency.GetPercentileSeconds(0.99) * 1000.0, FlushLatency.MaxSeconds * 1000.0);
+    Out += FString::Printf(TEXT("Memory: boards=%d rows=%d board=%llu B names=%llu B entry views=%llu B"),
+        ResidentBoards, ResidentRows, uint64(BoardBytes), uint64(NameTableBytes), uint64(EntryViewBytes));
+    return Out;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Latency histogram with power-of-two millisecond buckets: [0, 1), [1, 2), [2, 4) ... [16384, inf).
+// Fixed size and allocation free, so recording is cheap enough for shipping builds.
+struct FLeaderboardLatencyHistogram
+{
+    static constexpr int32 NumBuckets = 16;
+
+    uint32 Buckets[NumBuckets] = {};
+    uint32 Count = 0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+
+    void Add(double Seconds);
+    void Reset() { *this = FLeaderboardLatencyHistogram(); }
+
+    double GetAverageSeconds() const { return Count > 0 ? TotalSeconds / Count : 0.0; }
+    // Upper bound of the bucket holding the given fraction of samples
+    double GetPercentileSeconds(double Fraction) const;
+};
+
+struct FLeaderboardMetrics
+{
+    // Counters, reset by ULeaderboardManager::ResetMetrics
+    int64 ReadsIssued = 0;
+    int64 ReadsSucceeded = 0;
+    int64 ReadsFailed = 0;
+    int64 CacheHits = 0;
+    int64 CacheStaleHits = 0;
+    int64 CacheMisses = 0;
+    int64 ReadsDeduplicated = 0;
+    int64 ReadsTimedOut = 0;
+    int64 WritesQueued = 0;
+    int64 WritesRejectedByBackend = 0;
+    // Scores stopped by a board's FLeaderboardScoreGate before they were queued
+    int64 WritesRejectedOutOfRange = 0;
+    int64 WritesRejectedNotImproving = 0;
+    // Scores held back by MinWriteInterval; only the best of each interval is queued afterwards
+    int64 WritesThrottled = 0;
+    int64 FlushesIssued = 0;
+    int64 FlushesFailed = 0;
+    int64 WriteRetriesScheduled = 0;
+    // Writes given up after WriteMaxAttempts, or replayed from the journal for a board or player that no longer resolves
+    int64 WritesAbandoned = 0;
+    int64 RowsParsed = 0;
+    double ParseSeconds = 0.0;
+
+    FLeaderboardLatencyHistogram ReadLatency;
+    FLeaderboardLatencyHistogram FlushLatency;
+
+    // Current state, filled in when the metrics are fetched
+    int32 InFlightReads = 0;
+    int32 PendingWrites = 0;
+    int32 SessionsAwaitingFlush = 0;
+    int32 JournalOutstanding = 0;
+    int32 ResidentBoards = 0;
+    int32 ResidentRows = 0;
+    SIZE_T EntryViewBytes = 0;
+    SIZE_T BoardBytes = 0;
+    SIZE_T NameTableBytes = 0;
+
+    // Fresh and stale hits over every read that went through the cache lookup
+    double GetCacheHitRate() const;
+    double GetRowsParsedPerSecond() const { return ParseSeconds > 0.0 ? RowsParsed / ParseSeconds : 0.0; }
+
+    FString ToString() const;
+};
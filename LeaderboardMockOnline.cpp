@@ -0,0 +1,466 @@
+#include "LeaderboardMockOnline.h"
+#include "Algo/BinarySearch.h"
+
+namespace
+{
+    const FName MockIdType(TEXT("Mock"));
+    const TCHAR* MockIdPrefix = TEXT("MockPlayer_");
+    const TCHAR* MockLocalId = TEXT("MockLocalPlayer");
+}
+
+// ===== Identity =====
+
+FMockOnlineIdentity::FMockOnlineIdentity()
+    : LocalUserId(FUniqueNetIdString::Create(MockLocalId, MockIdType))
+{
+}
+
+bool FMockOnlineIdentity::Login(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials)
+{
+    TriggerOnLoginCompleteDelegates(LocalUserNum, true, *LocalUserId, FString());
+    return true;
+}
+
+bool FMockOnlineIdentity::Logout(int32 LocalUserNum)
+{
+    TriggerOnLogoutCompleteDelegates(LocalUserNum, true);
+    return true;
+}
+
+bool FMockOnlineIdentity::AutoLogin(int32 LocalUserNum)
+{
+    return Login(LocalUserNum, FOnlineAccountCredentials());
+}
+
+TSharedPtr<FUserOnlineAccount> FMockOnlineIdentity::GetUserAccount(const FUniqueNetId& UserId) const
+{
+    return nullptr;
+}
+
+TArray<TSharedPtr<FUserOnlineAccount>> FMockOnlineIdentity::GetAllUserAccounts() const
+{
+    return TArray<TSharedPtr<FUserOnlineAccount>>();
+}
+
+FUniqueNetIdPtr FMockOnlineIdentity::GetUniquePlayerId(int32 LocalUserNum) const
+{
+    return LocalUserNum == 0 ? FUniqueNetIdPtr(LocalUserId) : nullptr;
+}
+
+FUniqueNetIdPtr FMockOnlineIdentity::CreateUniquePlayerId(uint8* Bytes, int32 Size)
+{
+    if (Bytes && Size > 0)
+    {
+        return CreateUniquePlayerId(BytesToString(Bytes, Size));
+    }
+    return nullptr;
+}
+
+FUniqueNetIdPtr FMockOnlineIdentity::CreateUniquePlayerId(const FString& Str)
+{
+    return FUniqueNetIdString::Create(Str, MockIdType);
+}
+
+ELoginStatus::Type FMockOnlineIdentity::GetLoginStatus(int32 LocalUserNum) const
+{
+    return LocalUserNum == 0 ? ELoginStatus::LoggedIn : ELoginStatus::NotLoggedIn;
+}
+
+ELoginStatus::Type FMockOnlineIdentity::GetLoginStatus(const FUniqueNetId& UserId) const
+{
+    return UserId == *LocalUserId ? ELoginStatus::LoggedIn : ELoginStatus::NotLoggedIn;
+}
+
+FString FMockOnlineIdentity::GetPlayerNickname(int32 LocalUserNum) const
+{
+    return MockLocalId;
+}
+
+FString FMockOnlineIdentity::GetPlayerNickname(const FUniqueNetId& UserId) const
+{
+    return UserId.ToString();
+}
+
+FString FMockOnlineIdentity::GetAuthToken(int32 LocalUserNum) const
+{
+    return FString();
+}
+
+void FMockOnlineIdentity::RevokeAuthToken(const FUniqueNetId& InLocalUserId, const FOnRevokeAuthTokenCompleteDelegate& Delegate)
+{
+    Delegate.ExecuteIfBound(InLocalUserId, FOnlineError(true));
+}
+
+void FMockOnlineIdentity::GetUserPrivilege(const FUniqueNetId& InLocalUserId, EUserPrivileges::Type Privilege, const FOnGetUserPrivilegeCompleteDelegate& Delegate, EShowPrivilegeResolveUI ShowResolveUI)
+{
+    Delegate.ExecuteIfBound(InLocalUserId, Privilege, static_cast<uint32>(EPrivilegeResults::NoFailures));
+}
+
+FPlatformUserId FMockOnlineIdentity::GetPlatformUserIdFromUniqueNetId(const FUniqueNetId& UniqueNetId) const
+{
+    return UniqueNetId == *LocalUserId ? FPlatformMisc::GetPlatformUserForUserIndex(0) : PLATFORMUSERID_NONE;
+}
+
+FString FMockOnlineIdentity::GetAuthType() const
+{
+    return TEXT("Mock");
+}
+
+// ===== Leaderboards =====
+
+FMockOnlineLeaderboards::FMockOnlineLeaderboards(const FMockLeaderboardSettings& InSettings, FUniqueNetIdRef InLocalUserId)
+    : Settings(InSettings)
+    , LocalUserId(InLocalUserId)
+    , Random(InSettings.Seed)
+{
+    Settings.BoardSize = FMath::Max(Settings.BoardSize, 1);
+    Settings.FriendCount = FMath::Clamp(Settings.FriendCount, 0, Settings.BoardSize);
+    Settings.LocalPlayerRank = FMath::Clamp(Settings.LocalPlayerRank, 1, Settings.BoardSize);
+}
+
+FMockOnlineLeaderboards::~FMockOnlineLeaderboards()
+{
+    SetAutoTick(false);
+}
+
+FString FMockOnlineLeaderboards::MakePlayerId(int32 PlayerIndex)
+{
+    return PlayerIndex == INDEX_NONE ? FString(MockLocalId) : FString::Printf(TEXT("%s%d"), MockIdPrefix, PlayerIndex);
+}
+
+void FMockOnlineLeaderboards::SetAutoTick(bool bEnable)
+{
+    if (bEnable && !TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMockOnlineLeaderboards::Tick));
+    }
+    else if (!bEnable && TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+}
+
+bool FMockOnlineLeaderboards::Tick(float DeltaTime)
+{
+    ProcessPending(FPlatformTime::Seconds());
+    return true;
+}
+
+int32 FMockOnlineLeaderboards::ProcessPending(double Now)
+{
+    // Completions may issue new operations, so pull the due ones out before running any of them
+    TArray<FPendingOperation> Due;
+    for (int32 Index = PendingOperations.Num() - 1; Index >= 0; --Index)
+    {
+        if (PendingOperations[Index].DueTime <= Now)
+        {
+            Due.Add(MoveTemp(PendingOperations[Index]));
+            PendingOperations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        }
+    }
+
+    Due.Sort([](const FPendingOperation& A, const FPendingOperation& B) { return A.DueTime < B.DueTime; });
+    for (FPendingOperation& Operation : Due)
+    {
+        Operation.Complete();
+    }
+    return Due.Num();
+}
+
+void FMockOnlineLeaderboards::Schedule(TFunction<void()> Complete)
+{
+    FPendingOperation& Operation = PendingOperations.AddDefaulted_GetRef();
+    Operation.DueTime = FPlatformTime::Seconds() + Settings.LatencySeconds + Random.FRand() * Settings.LatencyJitterSeconds;
+    Operation.Complete = MoveTemp(Complete);
+}
+
+bool FMockOnlineLeaderboards::RollFailure()
+{
+    return Settings.FailureRate > 0.0f && Random.FRand() < Settings.FailureRate;
+}
+
+FMockOnlineLeaderboards::FMockBoard& FMockOnlineLeaderboards::FindOrCreateBoard(FName LeaderboardName)
+{
+    if (FMockBoard* Existing = Boards.Find(LeaderboardName))
+    {
+        return *Existing;
+    }
+
+    FMockBoard& Board = Boards.Add(LeaderboardName);
+    Board.Rows.SetNumUninitialized(Settings.BoardSize);
+
+    // Strictly descending scores so ranks are unambiguous, local user slotted in at LocalPlayerRank
+    int32 PlayerIndex = 0;
+    for (int32 Position = 0; Position < Settings.BoardSize; ++Position)
+    {
+        FMockRow& Row = Board.Rows[Position];
+        Row.Score = (Settings.BoardSize - Position) * 10;
+        Row.PlayerIndex = Position == Settings.LocalPlayerRank - 1 ? INDEX_NONE : PlayerIndex++;
+    }
+    Board.LocalPosition = Settings.LocalPlayerRank - 1;
+    return Board;
+}
+
+void FMockOnlineLeaderboards::SetPlayerScore(FMockBoard& Board, int32 PlayerIndex, int32 Score)
+{
+    // KeepBest, descending. Only the local user's position is tracked, everyone else is looked up.
+    const int32 OldPosition = PlayerIndex == INDEX_NONE
+        ? Board.LocalPosition
+        : Board.Rows.IndexOfByPredicate([PlayerIndex](const FMockRow& Row) { return Row.PlayerIndex == PlayerIndex; });
+    if (OldPosition != INDEX_NONE)
+    {
+        if (Board.Rows[OldPosition].Score >= Score)
+        {
+            return;
+        }
+        Board.Rows.RemoveAt(OldPosition, 1, EAllowShrinking::No);
+        if (OldPosition < Board.LocalPosition)
+        {
+            --Board.LocalPosition;
+        }
+    }
+
+    const int32 Position = Algo::LowerBound(Board.Rows, Score, [](const FMockRow& Row, int32 Value) { return Row.Score > Value; });
+
+    FMockRow NewRow;
+    NewRow.Score = Score;
+    NewRow.PlayerIndex = PlayerIndex;
+    Board.Rows.Insert(NewRow, Position);
+    if (PlayerIndex == INDEX_NONE)
+    {
+        Board.LocalPosition = Position;
+    }
+    else if (Position <= Board.LocalPosition)
+    {
+        ++Board.LocalPosition;
+    }
+}
+
+bool FMockOnlineLeaderboards::ResolvePlayerIndex(const FUniqueNetId& Player, bool bAdd, int32& OutPlayerIndex)
+{
+    if (Player == *LocalUserId)
+    {
+        OutPlayerIndex = INDEX_NONE;
+        return true;
+    }
+
+    const FString PlayerId = Player.ToString();
+    const int32 NumSyntheticPlayers = Settings.BoardSize - 1;
+    FString IndexString;
+    if (PlayerId.Split(MockIdPrefix, nullptr, &IndexString) && IndexString.IsNumeric())
+    {
+        const int32 PlayerIndex = FCString::Atoi(*IndexString);
+        if (PlayerIndex >= 0 && PlayerIndex < NumSyntheticPlayers)
+        {
+            OutPlayerIndex = PlayerIndex;
+            return true;
+        }
+    }
+
+    int32 WrittenIndex = WrittenPlayerIds.IndexOfByKey(PlayerId);
+    if (WrittenIndex == INDEX_NONE)
+    {
+        if (!bAdd)
+        {
+            return false;
+        }
+        WrittenIndex = WrittenPlayerIds.Add(PlayerId);
+    }
+    OutPlayerIndex = NumSyntheticPlayers + WrittenIndex;
+    return true;
+}
+
+FString FMockOnlineLeaderboards::GetPlayerId(int32 PlayerIndex) const
+{
+    const int32 WrittenIndex = PlayerIndex - (Settings.BoardSize - 1);
+    return WrittenPlayerIds.IsValidIndex(WrittenIndex) ? WrittenPlayerIds[WrittenIndex] : MakePlayerId(PlayerIndex);
+}
+
+void FMockOnlineLeaderboards::AppendRow(const FMockBoard& Board, int32 Position, FOnlineLeaderboardRead& ReadObject) const
+{
+    const FMockRow& Source = Board.Rows[Position];
+    const FString PlayerId = GetPlayerId(Source.PlayerIndex);
+
+    FOnlineStatsRow Row(PlayerId, Source.PlayerIndex == INDEX_NONE ? LocalUserId : FUniqueNetIdString::Create(PlayerId, MockIdType));
+    Row.Rank = Position + 1;
+    Row.Columns.Add(ReadObject.SortedColumn, FVariantData(Source.Score));
+    ReadObject.Rows.Add(MoveTemp(Row));
+}
+
+void FMockOnlineLeaderboards::CompleteRead(FOnlineLeaderboardReadRef ReadObject, bool bWasSuccessful)
+{
+    ++NumReads;
+    ReadObject->ReadState = EOnlineAsyncTaskState::InProgress;
+
+    // Rows are built up front so a benchmark timing the completion only measures the consumer
+    Schedule([this, ReadObject, bWasSuccessful]()
+    {
+        ReadObject->ReadState = bWasSuccessful ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+        TriggerOnLeaderboardReadCompleteDelegates(bWasSuccessful);
+    });
+}
+
+bool FMockOnlineLeaderboards::ReadLeaderboards(const TArray<FUniqueNetIdRef>& Players, FOnlineLeaderboardReadRef& ReadObject)
+{
+    ReadObject->Rows.Reset();
+    const bool bWasSuccessful = !RollFailure();
+    if (bWasSuccessful)
+    {
+        const FMockBoard& Board = FindOrCreateBoard(ReadObject->LeaderboardName);
+        for (const FUniqueNetIdRef& Player : Players)
+        {
+            int32 PlayerIndex = INDEX_NONE;
+            if (!ResolvePlayerIndex(*Player, false, PlayerIndex))
+            {
+                continue;
+            }
+
+            const int32 Position = PlayerIndex == INDEX_NONE
+                ? Board.LocalPosition
+                : Board.Rows.IndexOfByPredicate([PlayerIndex](const FMockRow& Row) { return Row.PlayerIndex == PlayerIndex; });
+            if (Position != INDEX_NONE)
+            {
+                AppendRow(Board, Position, *ReadObject);
+            }
+        }
+    }
+
+    CompleteRead(ReadObject, bWasSuccessful);
+    return true;
+}
+
+bool FMockOnlineLeaderboards::ReadLeaderboardsForFriends(int32 LocalUserNum, FOnlineLeaderboardReadRef& ReadObject)
+{
+    ReadObject->Rows.Reset();
+    const bool bWasSuccessful = !RollFailure();
+    if (bWasSuccessful)
+    {
+        // Friends are spread evenly across the board, the local user is always part of the result
+        const FMockBoard& Board = FindOrCreateBoard(ReadObject->LeaderboardName);
+        const int32 Stride = Settings.FriendCount > 0 ? FMath::Max(Board.Rows.Num() / Settings.FriendCount, 1) : 0;
+        bool bAddedLocal = false;
+        for (int32 Friend = 0; Friend < Settings.FriendCount; ++Friend)
+        {
+            const int32 Position = Friend * Stride;
+            if (!bAddedLocal && Board.LocalPosition <= Position)
+            {
+                AppendRow(Board, Board.LocalPosition, *ReadObject);
+                bAddedLocal = true;
+            }
+            if (Position != Board.LocalPosition)
+            {
+                AppendRow(Board, Position, *ReadObject);
+            }
+        }
+        if (!bAddedLocal)
+        {
+            AppendRow(Board, Board.LocalPosition, *ReadObject);
+        }
+    }
+
+    CompleteRead(ReadObject, bWasSuccessful);
+    return true;
+}
+
+bool FMockOnlineLeaderboards::ReadLeaderboardsAroundRank(int32 Rank, uint32 Range, FOnlineLeaderboardReadRef& ReadObject)
+{
+    ReadObject->Rows.Reset();
+    const bool bWasSuccessful = !RollFailure();
+    if (bWasSuccessful)
+    {
+        // OSS semantics: Range rows either side of Rank, clipped to the board
+        const FMockBoard& Board = FindOrCreateBoard(ReadObject->LeaderboardName);
+        const int32 Radius = static_cast<int32>(FMath::Min<uint32>(Range, MAX_int32 / 2));
+        const int32 First = FMath::Max(Rank - Radius, 1) - 1;
+        const int32 Last = FMath::Min(FMath::Max(Rank + Radius, 0), Board.Rows.Num());
+        ReadObject->Rows.Reserve(FMath::Max(Last - First, 0));
+        for (int32 Position = First; Position < Last; ++Position)
+        {
+            AppendRow(Board, Position, *ReadObject);
+        }
+    }
+
+    CompleteRead(ReadObject, bWasSuccessful);
+    return true;
+}
+
+bool FMockOnlineLeaderboards::ReadLeaderboardsAroundUser(FUniqueNetIdRef Player, uint32 Range, FOnlineLeaderboardReadRef& ReadObject)
+{
+    const FMockBoard& Board = FindOrCreateBoard(ReadObject->LeaderboardName);
+    return ReadLeaderboardsAroundRank(Board.LocalPosition + 1, Range, ReadObject);
+}
+
+void FMockOnlineLeaderboards::FreeStats(FOnlineLeaderboardRead& ReadObject)
+{
+}
+
+bool FMockOnlineLeaderboards::WriteLeaderboards(const FName& SessionName, const FUniqueNetId& Player, FOnlineLeaderboardWrite& WriteObject)
+{
+    ++NumWrites;
+    int32 PlayerIndex = INDEX_NONE;
+    if (RollFailure() || !ResolvePlayerIndex(Player, true, PlayerIndex))
+    {
+        return false;
+    }
+
+    const FVariantData* Stat = WriteObject.FindStatByName(WriteObject.RatedStat);
+    if (!Stat)
+    {
+        // Steam rates by board name, fall back to the only stat the manager ever sends
+        auto It = WriteObject.Properties.CreateConstIterator();
+        Stat = It ? &It.Value() : nullptr;
+    }
+    if (!Stat)
+    {
+        return false;
+    }
+
+    int32 Score = 0;
+    Stat->GetValue(Score);
+
+    // Dedicated servers write for any player, so writes are staged per player as well as per board
+    TArray<FStagedWrite>& Staged = StagedWritesBySession.FindOrAdd(SessionName);
+    for (const FName& LeaderboardName : WriteObject.LeaderboardNames)
+    {
+        FStagedWrite* Write = Staged.FindByPredicate([&LeaderboardName, PlayerIndex](const FStagedWrite& Existing)
+        {
+            return Existing.LeaderboardName == LeaderboardName && Existing.PlayerIndex == PlayerIndex;
+        });
+        if (Write)
+        {
+            Write->Score = FMath::Max(Write->Score, Score);
+        }
+        else
+        {
+            Staged.Add({ LeaderboardName, PlayerIndex, Score });
+        }
+    }
+    return true;
+}
+
+bool FMockOnlineLeaderboards::FlushLeaderboards(const FName& SessionName)
+{
+    ++NumFlushes;
+    const bool bWasSuccessful = !RollFailure();
+    const FName Session = SessionName;
+
+    Schedule([this, Session, bWasSuccessful]()
+    {
+        TArray<FStagedWrite> Staged;
+        if (StagedWritesBySession.RemoveAndCopyValue(Session, Staged) && bWasSuccessful)
+        {
+            for (const FStagedWrite& Write : Staged)
+            {
+                SetPlayerScore(FindOrCreateBoard(Write.LeaderboardName), Write.PlayerIndex, Write.Score);
+            }
+        }
+        TriggerOnLeaderboardFlushCompleteDelegates(Session, bWasSuccessful);
+    });
+    return true;
+}
+
+bool FMockOnlineLeaderboards::WriteOnlinePlayerRatings(const FName& SessionName, int32 LeaderboardId, const TArray<FOnlinePlayerScore>& PlayerScores)
+{
+    return false;
+}
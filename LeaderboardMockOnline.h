@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystemTypes.h"
+#include "Interfaces/OnlineLeaderboardInterface.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "Containers/Ticker.h"
+
+struct FMockLeaderboardSettings
+{
+    // Simulated round-trip of every read and flush, plus up to LatencyJitterSeconds of random extra delay
+    double LatencySeconds = 0.05;
+    double LatencyJitterSeconds = 0.02;
+
+    // Chance in [0, 1] that a read, write or flush fails
+    float FailureRate = 0.0f;
+
+    // Rows every board is seeded with on first access
+    int32 BoardSize = 100000;
+    int32 FriendCount = 100;
+
+    // Where the local user starts on each board, 1-based
+    int32 LocalPlayerRank = 500;
+
+    int32 Seed = 1337;
+};
+
+// Always logged-in identity for a single local user.
+class FMockOnlineIdentity : public IOnlineIdentity
+{
+public:
+    FMockOnlineIdentity();
+
+    FUniqueNetIdRef GetLocalUserId() const { return LocalUserId; }
+
+    virtual bool Login(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials) override;
+    virtual bool Logout(int32 LocalUserNum) override;
+    virtual bool AutoLogin(int32 LocalUserNum) override;
+    virtual TSharedPtr<FUserOnlineAccount> GetUserAccount(const FUniqueNetId& UserId) const override;
+    virtual TArray<TSharedPtr<FUserOnlineAccount>> GetAllUserAccounts() const override;
+    virtual FUniqueNetIdPtr GetUniquePlayerId(int32 LocalUserNum) const override;
+    virtual FUniqueNetIdPtr CreateUniquePlayerId(uint8* Bytes, int32 Size) override;
+    virtual FUniqueNetIdPtr CreateUniquePlayerId(const FString& Str) override;
+    virtual ELoginStatus::Type GetLoginStatus(int32 LocalUserNum) const override;
+    virtual ELoginStatus::Type GetLoginStatus(const FUniqueNetId& UserId) const override;
+    virtual FString GetPlayerNickname(int32 LocalUserNum) const override;
+    virtual FString GetPlayerNickname(const FUniqueNetId& UserId) const override;
+    virtual FString GetAuthToken(int32 LocalUserNum) const override;
+    virtual void RevokeAuthToken(const FUniqueNetId& LocalUserId, const FOnRevokeAuthTokenCompleteDelegate& Delegate) override;
+    virtual void GetUserPrivilege(const FUniqueNetId& LocalUserId, EUserPrivileges::Type Privilege, const FOnGetUserPrivilegeCompleteDelegate& Delegate, EShowPrivilegeResolveUI ShowResolveUI = EShowPrivilegeResolveUI::Default) override;
+    virtual FPlatformUserId GetPlatformUserIdFromUniqueNetId(const FUniqueNetId& UniqueNetId) const override;
+    virtual FString GetAuthType() const override;
+
+private:
+    FUniqueNetIdRef LocalUserId;
+};
+
+// In-process leaderboard backend with synthetic boards, configurable latency and failure injection.
+// Nothing completes on its own: call ProcessPending (or let the core ticker do it) to deliver due results.
+class FMockOnlineLeaderboards : public IOnlineLeaderboards
+{
+public:
+    FMockOnlineLeaderboards(const FMockLeaderboardSettings& InSettings, FUniqueNetIdRef InLocalUserId);
+    virtual ~FMockOnlineLeaderboards();
+
+    // Completes every operation whose simulated latency has elapsed and returns how many did.
+    int32 ProcessPending(double Now);
+    int32 NumPending() const { return PendingOperations.Num(); }
+
+    // Drives ProcessPending from the core ticker, for use outside of benchmark loops.
+    void SetAutoTick(bool bEnable);
+
+    int32 GetNumReads() const { return NumReads; }
+    int32 GetNumWrites() const { return NumWrites; }
+    int32 GetNumFlushes() const { return NumFlushes; }
+
+    static FString MakePlayerId(int32 PlayerIndex);
+
+    virtual bool ReadLeaderboards(const TArray<FUniqueNetIdRef>& Players, FOnlineLeaderboardReadRef& ReadObject) override;
+    virtual bool ReadLeaderboardsForFriends(int32 LocalUserNum, FOnlineLeaderboardReadRef& ReadObject) override;
+    virtual bool ReadLeaderboardsAroundRank(int32 Rank, uint32 Range, FOnlineLeaderboardReadRef& ReadObject) override;
+    virtual bool ReadLeaderboardsAroundUser(FUniqueNetIdRef Player, uint32 Range, FOnlineLeaderboardReadRef& ReadObject) override;
+    virtual void FreeStats(FOnlineLeaderboardRead& ReadObject) override;
+    virtual bool WriteLeaderboards(const FName& SessionName, const FUniqueNetId& Player, FOnlineLeaderboardWrite& WriteObject) override;
+    virtual bool FlushLeaderboards(const FName& SessionName) override;
+    virtual bool WriteOnlinePlayerRatings(const FName& SessionName, int32 LeaderboardId, const TArray<FOnlinePlayerScore>& PlayerScores) override;
+
+private:
+    struct FMockRow
+    {
+        int32 Score = 0;
+        // Index of the synthetic or written player, INDEX_NONE for the local user
+        int32 PlayerIndex = INDEX_NONE;
+    };
+
+    struct FMockBoard
+    {
+        // Sorted by score descending, rank is index + 1
+        TArray<FMockRow> Rows;
+        int32 LocalPosition = INDEX_NONE;
+    };
+
+    struct FStagedWrite
+    {
+        FName LeaderboardName;
+        int32 PlayerIndex = INDEX_NONE;
+        int32 Score = 0;
+    };
+
+    struct FPendingOperation
+    {
+        double DueTime = 0.0;
+        TFunction<void()> Complete;
+    };
+
+    FMockBoard& FindOrCreateBoard(FName LeaderboardName);
+    void SetPlayerScore(FMockBoard& Board, int32 PlayerIndex, int32 Score);
+    // INDEX_NONE for the local user. Players that aren't synthetic get an index past them once they write, bAdd permitting.
+    bool ResolvePlayerIndex(const FUniqueNetId& Player, bool bAdd, int32& OutPlayerIndex);
+    FString GetPlayerId(int32 PlayerIndex) const;
+    void AppendRow(const FMockBoard& Board, int32 Position, FOnlineLeaderboardRead& ReadObject) const;
+    bool RollFailure();
+    void Schedule(TFunction<void()> Complete);
+    void CompleteRead(FOnlineLeaderboardReadRef ReadObject, bool bWasSuccessful);
+    bool Tick(float DeltaTime);
+
+    FMockLeaderboardSettings Settings;
+    FUniqueNetIdRef LocalUserId;
+    FRandomStream Random;
+    TMap<FName, FMockBoard> Boards;
+    TMap<FName, TArray<FStagedWrite>> StagedWritesBySession;
+    // IDs of players written that aren't synthetic, indexed from the first index past the synthetic ones
+    TArray<FString> WrittenPlayerIds;
+    TArray<FPendingOperation> PendingOperations;
+    FTSTicker::FDelegateHandle TickerHandle;
+
+    int32 NumReads = 0;
+    int32 NumWrites = 0;
+    int32 NumFlushes = 0;
+};
@@ -0,0 +1,84 @@
+#include "LeaderboardNameTable.h"
+
+int32 FLeaderboardNameTable::Intern(const FString& Name)
+{
+    const uint32 Hash = GetTypeHash(Name);
+    const int32 Existing = FindHashed(Name, Hash);
+    if (Existing != INDEX_NONE)
+    {
+        return Existing;
+    }
+
+    const int32 Handle = Names.Add(Name);
+    HandlesByHash.Add(Hash, Handle);
+    return Handle;
+}
+
+int32 FLeaderboardNameTable::Intern(FString&& Name, uint32 Hash)
+{
+    const int32 Existing = FindHashed(Name, Hash);
+    if (Existing != INDEX_NONE)
+    {
+        return Existing;
+    }
+
+    const int32 Handle = Names.Add(MoveTemp(Name));
+    HandlesByHash.Add(Hash, Handle);
+    return Handle;
+}
+
+int32 FLeaderboardNameTable::Find(const FString& Name) const
+{
+    return FindHashed(Name, GetTypeHash(Name));
+}
+
+int32 FLeaderboardNameTable::FindHashed(const FString& Name, uint32 Hash) const
+{
+    for (TMultiMap<uint32, int32>::TConstKeyIterator It(HandlesByHash, Hash); It; ++It)
+    {
+        if (Names[It.Value()].Equals(Name, ESearchCase::CaseSensitive))
+        {
+            return It.Value();
+        }
+    }
+    return INDEX_NONE;
+}
+
+const FString& FLeaderboardNameTable::Get(int32 Handle) const
+{
+    static const FString Unknown(TEXT("Unknown"));
+    return Names.IsValidIndex(Handle) ? Names[Handle] : Unknown;
+}
+
+void FLeaderboardNameTable::Reset()
+{
+    Names.Empty();
+    HandlesByHash.Empty();
+}
+
+void FLeaderboardNameTable::Compact(const TBitArray<>& Live, TArray<int32>& OutRemap)
+{
+    OutRemap.Init(INDEX_NONE, Names.Num());
+    TArray<FString> LiveNames;
+    HandlesByHash.Reset();
+    for (int32 Handle = 0; Handle < Names.Num(); ++Handle)
+    {
+        if (Handle < Live.Num() && Live[Handle])
+        {
+            const int32 NewHandle = LiveNames.Add(MoveTemp(Names[Handle]));
+            HandlesByHash.Add(GetTypeHash(LiveNames[NewHandle]), NewHandle);
+            OutRemap[Handle] = NewHandle;
+        }
+    }
+    Names = MoveTemp(LiveNames);
+}
+
+SIZE_T FLeaderboardNameTable::GetAllocatedSize() const
+{
+    SIZE_T Size = Names.GetAllocatedSize() + HandlesByHash.GetAllocatedSize();
+    for (const FString& Name : Names)
+    {
+        Size += Name.GetAllocatedSize();
+    }
+    return Size;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Interns player names and IDs so resident rows only carry small integer handles.
+// Each string is stored once; lookups go through a hash multimap into the name array.
+class FLeaderboardNameTable
+{
+public:
+    // Returns the handle of Name, adding it if it wasn't interned yet.
+    int32 Intern(const FString& Name);
+
+    // Same as above for a string hashed with GetTypeHash ahead of time, e.g. on a parsing worker.
+    int32 Intern(FString&& Name, uint32 Hash);
+
+    // Returns the handle of Name, or INDEX_NONE without adding it.
+    int32 Find(const FString& Name) const;
+
+    const FString& Get(int32 Handle) const;
+
+    void Reset();
+
+    // Rebuilds the table from the handles set in Live, in their current order, and fills OutRemap with each old
+    // handle's new one (INDEX_NONE for dropped ones). Every row holding a handle has to be remapped with it.
+    void Compact(const TBitArray<>& Live, TArray<int32>& OutRemap);
+
+    int32 Num() const { return Names.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    int32 FindHashed(const FString& Name, uint32 Hash) const;
+
+    TArray<FString> Names;
+    TMultiMap<uint32, int32> HandlesByHash;
+};
@@ -0,0 +1,346 @@
+#include "LeaderboardPagedStore.h"
+#include "HAL/PlatformTime.h"
+
+FLeaderboardRow FLeaderboardPagedStore::FPage::GetRow(int32 Slot) const
+{
+    FLeaderboardRow Row;
+    Row.Rank = Ranks[Slot];
+    Row.Score = Scores[Slot];
+    Row.PlayerHandle = PlayerHandles[Slot];
+    Row.NameHandle = NameHandles[Slot];
+    return Row;
+}
+
+void FLeaderboardPagedStore::FPage::SetRow(int32 Slot, const FLeaderboardRow& Row)
+{
+    Ranks[Slot] = Row.Rank;
+    Scores[Slot] = Row.Score;
+    PlayerHandles[Slot] = Row.PlayerHandle;
+    NameHandles[Slot] = Row.NameHandle;
+}
+
+void FLeaderboardPagedStore::FPage::ClearRow(int32 Slot)
+{
+    Ranks[Slot] = 0;
+    Scores[Slot] = 0;
+    PlayerHandles[Slot] = INDEX_NONE;
+    NameHandles[Slot] = INDEX_NONE;
+}
+
+FLeaderboardPagedStore::FLeaderboardPagedStore(int32 InPageSize)
+    : PageSize(FMath::Max(InPageSize, 1))
+{
+}
+
+void FLeaderboardPagedStore::Reset()
+{
+    Pages.Empty();
+    RankByPlayer.Empty();
+}
+
+FLeaderboardPagedStore::FPage& FLeaderboardPagedStore::FindOrAddPage(int32 PageIndex)
+{
+    if (FPage* Existing = Pages.Find(PageIndex))
+    {
+        return *Existing;
+    }
+
+    FPage& Page = Pages.Add(PageIndex);
+    Page.Ranks.SetNumZeroed(PageSize);
+    Page.Scores.SetNumZeroed(PageSize);
+    Page.PlayerHandles.Init(INDEX_NONE, PageSize);
+    Page.NameHandles.Init(INDEX_NONE, PageSize);
+    Page.Covered.Init(false, PageSize);
+    return Page;
+}
+
+bool FLeaderboardPagedStore::IsRankCovered(int32 Rank) const
+{
+    if (Rank < 1)
+    {
+        return false;
+    }
+    const FPage* Page = Pages.Find((Rank - 1) / PageSize);
+    return Page && Page->Covered[(Rank - 1) % PageSize];
+}
+
+void FLeaderboardPagedStore::ClearSlot(int32 Rank, bool bUncover, TArray<FLeaderboardRow>* OutRemoved)
+{
+    FPage* Page = Pages.Find((Rank - 1) / PageSize);
+    if (!Page)
+    {
+        return;
+    }
+
+    const int32 Slot = (Rank - 1) % PageSize;
+    if (Page->Ranks[Slot] != 0)
+    {
+        RankByPlayer.Remove(Page->PlayerHandles[Slot]);
+        if (OutRemoved)
+        {
+            OutRemoved->Add(Page->GetRow(Slot));
+        }
+        Page->ClearRow(Slot);
+        --Page->NumRows;
+    }
+    if (bUncover)
+    {
+        Page->Covered[Slot] = false;
+    }
+}
+
+void FLeaderboardPagedStore::MergeWindow(int32 RankFirst, int32 RankCount, const TArray<FLeaderboardRow>& Rows, TArray<FLeaderboardRow>& OutRemoved)
+{
+    // Backends interpret the window differently, so widen it to whatever actually came back
+    int32 WindowFirst = FMath::Max(RankFirst, 1);
+    int32 WindowLast = RankFirst + RankCount - 1;
+    for (const FLeaderboardRow& Row : Rows)
+    {
+        if (Row.Rank > 0)
+        {
+            WindowFirst = FMath::Min(WindowFirst, Row.Rank);
+            WindowLast = FMath::Max(WindowLast, Row.Rank);
+        }
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    TArray<FLeaderboardRow> Displaced;
+    for (int32 Rank = WindowFirst; Rank <= WindowLast; ++Rank)
+    {
+        ClearSlot(Rank, false, &Displaced);
+        FPage& Page = FindOrAddPage((Rank - 1) / PageSize);
+        Page.Covered[(Rank - 1) % PageSize] = true;
+        Page.LastViewedTime = Now;
+    }
+
+    TSet<int32> Seen;
+    Seen.Reserve(Rows.Num());
+    for (const FLeaderboardRow& Row : Rows)
+    {
+        if (Row.Rank <= 0)
+        {
+            continue;
+        }
+
+        // A player who moved here from a page outside the window leaves a hole we can no longer vouch for
+        if (const int32* OldRank = RankByPlayer.Find(Row.PlayerHandle))
+        {
+            ClearSlot(*OldRank, true, nullptr);
+        }
+
+        FPage& Page = FindOrAddPage((Row.Rank - 1) / PageSize);
+        const int32 Slot = (Row.Rank - 1) % PageSize;
+        if (Page.Ranks[Slot] != 0)
+        {
+            // Tied rank inside the same window, last row wins. The row it replaces is reported like any other
+            // displaced one, its player may already be in the caller's index from this read.
+            const FLeaderboardRow Overwritten = Page.GetRow(Slot);
+            RankByPlayer.Remove(Overwritten.PlayerHandle);
+            Seen.Remove(Overwritten.PlayerHandle);
+            Displaced.Add(Overwritten);
+            --Page.NumRows;
+        }
+        Page.SetRow(Slot, Row);
+        ++Page.NumRows;
+        RankByPlayer.Add(Row.PlayerHandle, Row.Rank);
+        Seen.Add(Row.PlayerHandle);
+    }
+
+    // Seen also stops a player displaced twice, by the window and again by a tie, being reported twice
+    for (const FLeaderboardRow& Row : Displaced)
+    {
+        bool bAlreadySeen = false;
+        Seen.Add(Row.PlayerHandle, &bAlreadySeen);
+        if (!bAlreadySeen)
+        {
+            OutRemoved.Add(Row);
+        }
+    }
+}
+
+void FLeaderboardPagedStore::Touch(int32 RankFirst, int32 RankCount)
+{
+    if (RankCount <= 0)
+    {
+        return;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    const int32 FirstPage = (FMath::Max(RankFirst, 1) - 1) / PageSize;
+    const int32 LastPage = (FMath::Max(RankFirst + RankCount - 1, 1) - 1) / PageSize;
+    for (TPair<int32, FPage>& Page : Pages)
+    {
+        if (Page.Key >= FirstPage && Page.Key <= LastPage)
+        {
+            Page.Value.LastViewedTime = Now;
+        }
+    }
+}
+
+void FLeaderboardPagedStore::EvictToBudget(int32 MaxResidentRows, TArray<FLeaderboardRow>& OutEvicted)
+{
+    if (MaxResidentRows <= 0 || NumRows() <= MaxResidentRows || Pages.Num() <= 1)
+    {
+        return;
+    }
+
+    TArray<TPair<double, int32>> ByAge;
+    ByAge.Reserve(Pages.Num());
+    for (const TPair<int32, FPage>& Page : Pages)
+    {
+        ByAge.Emplace(Page.Value.LastViewedTime, Page.Key);
+    }
+    ByAge.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B)
+    {
+        return A.Key < B.Key;
+    });
+
+    for (int32 Index = 0; Index < ByAge.Num() - 1 && NumRows() > MaxResidentRows; ++Index)
+    {
+        FPage Page;
+        if (!Pages.RemoveAndCopyValue(ByAge[Index].Value, Page))
+        {
+            continue;
+        }
+        for (int32 Slot = 0; Slot < PageSize; ++Slot)
+        {
+            if (Page.Ranks[Slot] != 0)
+            {
+                RankByPlayer.Remove(Page.PlayerHandles[Slot]);
+                OutEvicted.Add(Page.GetRow(Slot));
+            }
+        }
+    }
+}
+
+void FLeaderboardPagedStore::GetResidentRanges(TArray<FLeaderboardRankRange>& OutRanges) const
+{
+    OutRanges.Reset();
+    for (const TPair<int32, FPage>& Page : Pages)
+    {
+        for (int32 Slot = 0; Slot < PageSize; ++Slot)
+        {
+            if (!Page.Value.Covered[Slot])
+            {
+                continue;
+            }
+
+            const int32 Rank = Page.Key * PageSize + Slot + 1;
+            if (OutRanges.Num() > 0 && OutRanges.Last().RankFirst + OutRanges.Last().RankCount == Rank)
+            {
+                ++OutRanges.Last().RankCount;
+            }
+            else
+            {
+                FLeaderboardRankRange& Range = OutRanges.AddDefaulted_GetRef();
+                Range.RankFirst = Rank;
+                Range.RankCount = 1;
+            }
+        }
+    }
+}
+
+void FLeaderboardPagedStore::GetMissingRanges(int32 RankFirst, int32 RankCount, TArray<FLeaderboardRankRange>& OutRanges) const
+{
+    OutRanges.Reset();
+    for (int32 Rank = FMath::Max(RankFirst, 1); Rank < RankFirst + RankCount; ++Rank)
+    {
+        if (IsRankCovered(Rank))
+        {
+            continue;
+        }
+
+        if (OutRanges.Num() > 0 && OutRanges.Last().RankFirst + OutRanges.Last().RankCount == Rank)
+        {
+            ++OutRanges.Last().RankCount;
+        }
+        else
+        {
+            FLeaderboardRankRange& Range = OutRanges.AddDefaulted_GetRef();
+            Range.RankFirst = Rank;
+            Range.RankCount = 1;
+        }
+    }
+}
+
+bool FLeaderboardPagedStore::IsRangeResident(int32 RankFirst, int32 RankCount) const
+{
+    for (int32 Rank = FMath::Max(RankFirst, 1); Rank < RankFirst + RankCount; ++Rank)
+    {
+        if (!IsRankCovered(Rank))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FLeaderboardPagedStore::ToArray(TArray<FLeaderboardRow>& OutRows) const
+{
+    OutRows.Reset(NumRows());
+    for (const TPair<int32, FPage>& Page : Pages)
+    {
+        const FPage& Rows = Page.Value;
+        for (int32 Slot = 0; Slot < PageSize; ++Slot)
+        {
+            if (Rows.Ranks[Slot] != 0)
+            {
+                OutRows.Add(Rows.GetRow(Slot));
+            }
+        }
+    }
+}
+
+void FLeaderboardPagedStore::MarkHandles(TBitArray<>& Live) const
+{
+    for (const TPair<int32, FPage>& Page : Pages)
+    {
+        for (int32 Slot = 0; Slot < PageSize; ++Slot)
+        {
+            if (Page.Value.Ranks[Slot] == 0)
+            {
+                continue;
+            }
+            for (const int32 Handle : { Page.Value.PlayerHandles[Slot], Page.Value.NameHandles[Slot] })
+            {
+                if (Live.IsValidIndex(Handle))
+                {
+                    Live[Handle] = true;
+                }
+            }
+        }
+    }
+}
+
+void FLeaderboardPagedStore::RemapHandles(const TArray<int32>& Remap)
+{
+    RankByPlayer.Reset();
+    for (TPair<int32, FPage>& Page : Pages)
+    {
+        FPage& Rows = Page.Value;
+        for (int32 Slot = 0; Slot < PageSize; ++Slot)
+        {
+            if (Rows.Ranks[Slot] == 0)
+            {
+                continue;
+            }
+            int32& PlayerHandle = Rows.PlayerHandles[Slot];
+            int32& NameHandle = Rows.NameHandles[Slot];
+            PlayerHandle = Remap.IsValidIndex(PlayerHandle) ? Remap[PlayerHandle] : INDEX_NONE;
+            NameHandle = Remap.IsValidIndex(NameHandle) ? Remap[NameHandle] : INDEX_NONE;
+            RankByPlayer.Add(PlayerHandle, Rows.Ranks[Slot]);
+        }
+    }
+}
+
+SIZE_T FLeaderboardPagedStore::GetAllocatedSize() const
+{
+    SIZE_T Size = Pages.GetAllocatedSize() + RankByPlayer.GetAllocatedSize();
+    for (const TPair<int32, FPage>& Page : Pages)
+    {
+        Size += Page.Value.Ranks.GetAllocatedSize() + Page.Value.Scores.GetAllocatedSize()
+            + Page.Value.PlayerHandles.GetAllocatedSize() + Page.Value.NameHandles.GetAllocatedSize()
+            + Page.Value.Covered.GetAllocatedSize();
+    }
+    return Size;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SortedMap.h"
+#include "LeaderboardTypes.h"
+
+// Sparse rank-addressed storage for one leaderboard. Rows live in fixed-size pages keyed by rank,
+// successive read windows are merged in place and the least recently viewed pages are evicted first.
+// Pages keep scores, player handles and name handles in parallel arrays indexed by rank slot.
+class FLeaderboardPagedStore
+{
+public:
+    explicit FLeaderboardPagedStore(int32 InPageSize = 50);
+
+    void Reset();
+
+    // Replaces everything resident in [RankFirst, RankFirst + RankCount) with Rows. Players that left the
+    // window and weren't seen elsewhere in it are appended to OutRemoved.
+    void MergeWindow(int32 RankFirst, int32 RankCount, const TArray<FLeaderboardRow>& Rows, TArray<FLeaderboardRow>& OutRemoved);
+
+    // Refreshes the LRU stamp of every page overlapping the range.
+    void Touch(int32 RankFirst, int32 RankCount);
+
+    // Drops least recently viewed pages until at most MaxResidentRows remain. The most recent page is always kept.
+    void EvictToBudget(int32 MaxResidentRows, TArray<FLeaderboardRow>& OutEvicted);
+
+    void GetResidentRanges(TArray<FLeaderboardRankRange>& OutRanges) const;
+    void GetMissingRanges(int32 RankFirst, int32 RankCount, TArray<FLeaderboardRankRange>& OutRanges) const;
+    bool IsRangeResident(int32 RankFirst, int32 RankCount) const;
+
+    // Resident rows in rank order.
+    void ToArray(TArray<FLeaderboardRow>& OutRows) const;
+
+    // Same as FLeaderboardRankIndex, for name table compaction.
+    void MarkHandles(TBitArray<>& Live) const;
+    void RemapHandles(const TArray<int32>& Remap);
+
+    int32 NumRows() const { return RankByPlayer.Num(); }
+    int32 GetPageSize() const { return PageSize; }
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FPage
+    {
+        // One slot per rank in the page, a zero rank marks an empty slot
+        TArray<int32> Ranks;
+        TArray<int32> Scores;
+        TArray<int32> PlayerHandles;
+        TArray<int32> NameHandles;
+        // Ranks a read has confirmed, including ones that came back empty past the end of the board
+        TBitArray<> Covered;
+        int32 NumRows = 0;
+        double LastViewedTime = 0.0;
+
+        FLeaderboardRow GetRow(int32 Slot) const;
+        void SetRow(int32 Slot, const FLeaderboardRow& Row);
+        void ClearRow(int32 Slot);
+    };
+
+    FPage& FindOrAddPage(int32 PageIndex);
+    bool IsRankCovered(int32 Rank) const;
+    void ClearSlot(int32 Rank, bool bUncover, TArray<FLeaderboardRow>* OutRemoved);
+
+    int32 PageSize;
+    TSortedMap<int32, FPage> Pages;
+    TMap<int32, int32> RankByPlayer;
+};
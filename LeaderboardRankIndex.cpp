@@ -0,0 +1,320 @@
+#include "LeaderboardRankIndex.h"
+
+void FLeaderboardRankIndex::Reset()
+{
+    Nodes.Reset();
+    FreeNodes.Reset();
+    NodeByPlayer.Reset();
+    Root = INDEX_NONE;
+}
+
+void FLeaderboardRankIndex::Reserve(int32 Number)
+{
+    Nodes.Reserve(Number);
+    NodeByPlayer.Reserve(Number);
+}
+
+bool FLeaderboardRankIndex::IsOrderedBefore(const FLeaderboardRow& A, const FLeaderboardRow& B)
+{
+    if (A.Score != B.Score)
+    {
+        return A.Score > B.Score;
+    }
+    if (A.Rank != B.Rank)
+    {
+        return A.Rank < B.Rank;
+    }
+    return A.PlayerHandle < B.PlayerHandle;
+}
+
+void FLeaderboardRankIndex::UpdateSize(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    Node.Size = 1 + SizeOf(Node.Left) + SizeOf(Node.Right);
+}
+
+uint32 FLeaderboardRankIndex::NextPriority()
+{
+    // xorshift32, only needs to be well spread, not random
+    PrioritySeed ^= PrioritySeed << 13;
+    PrioritySeed ^= PrioritySeed >> 17;
+    PrioritySeed ^= PrioritySeed << 5;
+    return PrioritySeed;
+}
+
+void FLeaderboardRankIndex::Split(int32 NodeIndex, const FLeaderboardRow& Key, bool bInclusive, int32& OutLeft, int32& OutRight)
+{
+    if (NodeIndex == INDEX_NONE)
+    {
+        OutLeft = INDEX_NONE;
+        OutRight = INDEX_NONE;
+        return;
+    }
+
+    const FLeaderboardRow& NodeRow = Nodes[NodeIndex].Row;
+    const bool bGoesLeft = bInclusive ? !IsOrderedBefore(Key, NodeRow) : IsOrderedBefore(NodeRow, Key);
+    if (bGoesLeft)
+    {
+        int32 SplitLeft, SplitRight;
+        Split(Nodes[NodeIndex].Right, Key, bInclusive, SplitLeft, SplitRight);
+        Nodes[NodeIndex].Right = SplitLeft;
+        UpdateSize(NodeIndex);
+        OutLeft = NodeIndex;
+        OutRight = SplitRight;
+    }
+    else
+    {
+        int32 SplitLeft, SplitRight;
+        Split(Nodes[NodeIndex].Left, Key, bInclusive, SplitLeft, SplitRight);
+        Nodes[NodeIndex].Left = SplitRight;
+        UpdateSize(NodeIndex);
+        OutLeft = SplitLeft;
+        OutRight = NodeIndex;
+    }
+}
+
+int32 FLeaderboardRankIndex::Merge(int32 LeftIndex, int32 RightIndex)
+{
+    if (LeftIndex == INDEX_NONE)
+    {
+        return RightIndex;
+    }
+    if (RightIndex == INDEX_NONE)
+    {
+        return LeftIndex;
+    }
+
+    if (Nodes[LeftIndex].Priority > Nodes[RightIndex].Priority)
+    {
+        Nodes[LeftIndex].Right = Merge(Nodes[LeftIndex].Right, RightIndex);
+        UpdateSize(LeftIndex);
+        return LeftIndex;
+    }
+
+    Nodes[RightIndex].Left = Merge(LeftIndex, Nodes[RightIndex].Left);
+    UpdateSize(RightIndex);
+    return RightIndex;
+}
+
+void FLeaderboardRankIndex::Upsert(const FLeaderboardRow& Row)
+{
+    // Row may point into Nodes, which can reallocate below
+    const FLeaderboardRow NewRow = Row;
+    if (NodeByPlayer.Contains(NewRow.PlayerHandle))
+    {
+        Remove(NewRow.PlayerHandle);
+    }
+
+    int32 NodeIndex;
+    if (FreeNodes.Num() > 0)
+    {
+        NodeIndex = FreeNodes.Pop(EAllowShrinking::No);
+        Nodes[NodeIndex] = FNode();
+    }
+    else
+    {
+        NodeIndex = Nodes.AddDefaulted();
+    }
+
+    FNode& Node = Nodes[NodeIndex];
+    Node.Row = NewRow;
+    Node.Priority = NextPriority();
+    NodeByPlayer.Add(NewRow.PlayerHandle, NodeIndex);
+
+    int32 Left, Right;
+    Split(Root, NewRow, false, Left, Right);
+    Root = Merge(Merge(Left, NodeIndex), Right);
+}
+
+bool FLeaderboardRankIndex::Remove(int32 PlayerHandle)
+{
+    int32 NodeIndex = INDEX_NONE;
+    if (!NodeByPlayer.RemoveAndCopyValue(PlayerHandle, NodeIndex))
+    {
+        return false;
+    }
+
+    // Cut out exactly the [Key, Key] slice, which is the node itself since player handles are unique
+    const FLeaderboardRow Key = Nodes[NodeIndex].Row;
+    int32 Left, Middle, Right;
+    Split(Root, Key, false, Left, Middle);
+    Split(Middle, Key, true, Middle, Right);
+    Root = Merge(Left, Right);
+
+    FreeNodes.Add(NodeIndex);
+    return true;
+}
+
+const FLeaderboardRow* FLeaderboardRankIndex::FindPlayer(int32 PlayerHandle) const
+{
+    const int32* NodeIndex = NodeByPlayer.Find(PlayerHandle);
+    return NodeIndex ? &Nodes[*NodeIndex].Row : nullptr;
+}
+
+int32 FLeaderboardRankIndex::FindPosition(const FLeaderboardRow& Key) const
+{
+    int32 Position = 0;
+    int32 NodeIndex = Root;
+    while (NodeIndex != INDEX_NONE)
+    {
+        const FNode& Node = Nodes[NodeIndex];
+        if (IsOrderedBefore(Key, Node.Row))
+        {
+            NodeIndex = Node.Left;
+        }
+        else if (IsOrderedBefore(Node.Row, Key))
+        {
+            Position += SizeOf(Node.Left) + 1;
+            NodeIndex = Node.Right;
+        }
+        else
+        {
+            return Position + SizeOf(Node.Left);
+        }
+    }
+    return INDEX_NONE;
+}
+
+int32 FLeaderboardRankIndex::GetPositionOfPlayer(int32 PlayerHandle) const
+{
+    const FLeaderboardRow* Row = FindPlayer(PlayerHandle);
+    return Row ? FindPosition(*Row) : INDEX_NONE;
+}
+
+const FLeaderboardRow* FLeaderboardRankIndex::GetEntryAt(int32 Position) const
+{
+    if (Position < 0 || Position >= SizeOf(Root))
+    {
+        return nullptr;
+    }
+
+    int32 NodeIndex = Root;
+    while (NodeIndex != INDEX_NONE)
+    {
+        const FNode& Node = Nodes[NodeIndex];
+        const int32 LeftSize = SizeOf(Node.Left);
+        if (Position < LeftSize)
+        {
+            NodeIndex = Node.Left;
+        }
+        else if (Position == LeftSize)
+        {
+            return &Node.Row;
+        }
+        else
+        {
+            Position -= LeftSize + 1;
+            NodeIndex = Node.Right;
+        }
+    }
+    return nullptr;
+}
+
+int32 FLeaderboardRankIndex::CountScoresAbove(int32 Score) const
+{
+    int32 Count = 0;
+    int32 NodeIndex = Root;
+    while (NodeIndex != INDEX_NONE)
+    {
+        const FNode& Node = Nodes[NodeIndex];
+        if (Node.Row.Score > Score)
+        {
+            Count += SizeOf(Node.Left) + 1;
+            NodeIndex = Node.Right;
+        }
+        else
+        {
+            NodeIndex = Node.Left;
+        }
+    }
+    return Count;
+}
+
+void FLeaderboardRankIndex::AppendInOrder(int32 NodeIndex, int32 FirstPosition, int32 LastPosition, int32 SubtreeOffset, TArray<FLeaderboardRow>& OutRows) const
+{
+    if (NodeIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    const FNode& Node = Nodes[NodeIndex];
+    const int32 NodePosition = SubtreeOffset + SizeOf(Node.Left);
+    if (FirstPosition < NodePosition)
+    {
+        AppendInOrder(Node.Left, FirstPosition, LastPosition, SubtreeOffset, OutRows);
+    }
+    if (NodePosition >= FirstPosition && NodePosition <= LastPosition)
+    {
+        OutRows.Add(Node.Row);
+    }
+    if (LastPosition > NodePosition)
+    {
+        AppendInOrder(Node.Right, FirstPosition, LastPosition, NodePosition + 1, OutRows);
+    }
+}
+
+void FLeaderboardRankIndex::GetRange(int32 FirstPosition, int32 Count, TArray<FLeaderboardRow>& OutRows) const
+{
+    OutRows.Reset();
+    FirstPosition = FMath::Max(FirstPosition, 0);
+    const int32 LastPosition = FMath::Min(FirstPosition + Count, SizeOf(Root)) - 1;
+    if (LastPosition < FirstPosition)
+    {
+        return;
+    }
+
+    OutRows.Reserve(LastPosition - FirstPosition + 1);
+    AppendInOrder(Root, FirstPosition, LastPosition, 0, OutRows);
+}
+
+void FLeaderboardRankIndex::GetEntriesAround(int32 PlayerHandle, int32 Radius, TArray<FLeaderboardRow>& OutRows) const
+{
+    const int32 Position = GetPositionOfPlayer(PlayerHandle);
+    if (Position == INDEX_NONE)
+    {
+        OutRows.Reset();
+        return;
+    }
+
+    Radius = FMath::Max(Radius, 0);
+    GetRange(Position - Radius, Radius * 2 + 1 - FMath::Max(Radius - Position, 0), OutRows);
+}
+
+void FLeaderboardRankIndex::ToArray(TArray<FLeaderboardRow>& OutRows) const
+{
+    GetRange(0, SizeOf(Root), OutRows);
+}
+
+void FLeaderboardRankIndex::MarkHandles(TBitArray<>& Live) const
+{
+    for (const TPair<int32, int32>& Pair : NodeByPlayer)
+    {
+        const FLeaderboardRow& Row = Nodes[Pair.Value].Row;
+        for (const int32 Handle : { Row.PlayerHandle, Row.NameHandle })
+        {
+            if (Live.IsValidIndex(Handle))
+            {
+                Live[Handle] = true;
+            }
+        }
+    }
+}
+
+void FLeaderboardRankIndex::RemapHandles(const TArray<int32>& Remap)
+{
+    TMap<int32, int32> RemappedNodes;
+    RemappedNodes.Reserve(NodeByPlayer.Num());
+    for (const TPair<int32, int32>& Pair : NodeByPlayer)
+    {
+        FLeaderboardRow& Row = Nodes[Pair.Value].Row;
+        Row.PlayerHandle = Remap.IsValidIndex(Row.PlayerHandle) ? Remap[Row.PlayerHandle] : INDEX_NONE;
+        Row.NameHandle = Remap.IsValidIndex(Row.NameHandle) ? Remap[Row.NameHandle] : INDEX_NONE;
+        RemappedNodes.Add(Row.PlayerHandle, Pair.Value);
+    }
+    NodeByPlayer = MoveTemp(RemappedNodes);
+}
+
+SIZE_T FLeaderboardRankIndex::GetAllocatedSize() const
+{
+    return Nodes.GetAllocatedSize() + FreeNodes.GetAllocatedSize() + NodeByPlayer.GetAllocatedSize();
+}
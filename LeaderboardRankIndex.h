@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardTypes.h"
+
+// Order-statistic treap over leaderboard rows, ordered by score (descending), then rank, then player handle.
+// Gives O(log n) upsert/remove, rank-of-player, k-th entry and "N around player" lookups.
+class FLeaderboardRankIndex
+{
+public:
+    void Reset();
+    void Reserve(int32 Number);
+
+    // Inserts the row, or moves it if a row with the same PlayerHandle is already indexed.
+    void Upsert(const FLeaderboardRow& Row);
+    bool Remove(int32 PlayerHandle);
+
+    int32 Num() const { return NodeByPlayer.Num(); }
+
+    const FLeaderboardRow* FindPlayer(int32 PlayerHandle) const;
+
+    // Zero-based position of the player in index order, or INDEX_NONE.
+    int32 GetPositionOfPlayer(int32 PlayerHandle) const;
+    const FLeaderboardRow* GetEntryAt(int32 Position) const;
+
+    // Number of indexed rows with a strictly higher score.
+    int32 CountScoresAbove(int32 Score) const;
+
+    void GetRange(int32 FirstPosition, int32 Count, TArray<FLeaderboardRow>& OutRows) const;
+    void GetEntriesAround(int32 PlayerHandle, int32 Radius, TArray<FLeaderboardRow>& OutRows) const;
+    void ToArray(TArray<FLeaderboardRow>& OutRows) const;
+
+    // Sets the bit of every player and name handle held, for name table compaction.
+    void MarkHandles(TBitArray<>& Live) const;
+    // Rewrites every handle through Remap. Compaction keeps handles in order, so the tree order still holds.
+    void RemapHandles(const TArray<int32>& Remap);
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FNode
+    {
+        FLeaderboardRow Row;
+        uint32 Priority = 0;
+        int32 Left = INDEX_NONE;
+        int32 Right = INDEX_NONE;
+        int32 Size = 1;
+    };
+
+    static bool IsOrderedBefore(const FLeaderboardRow& A, const FLeaderboardRow& B);
+
+    int32 SizeOf(int32 NodeIndex) const { return NodeIndex == INDEX_NONE ? 0 : Nodes[NodeIndex].Size; }
+    void UpdateSize(int32 NodeIndex);
+    uint32 NextPriority();
+
+    // Splits the subtree into rows ordered before Key (or before-or-equal when bInclusive) and the rest.
+    void Split(int32 NodeIndex, const FLeaderboardRow& Key, bool bInclusive, int32& OutLeft, int32& OutRight);
+    int32 Merge(int32 LeftIndex, int32 RightIndex);
+    int32 FindPosition(const FLeaderboardRow& Key) const;
+    void AppendInOrder(int32 NodeIndex, int32 FirstPosition, int32 LastPosition, int32 SubtreeOffset, TArray<FLeaderboardRow>& OutRows) const;
+
+    TArray<FNode> Nodes;
+    TArray<int32> FreeNodes;
+    TMap<int32, int32> NodeByPlayer;
+    int32 Root = INDEX_NONE;
+    uint32 PrioritySeed = 0x9E3779B9u;
+};
@@ -0,0 +1,235 @@
+#include "LeaderboardSnapshot.h"
+#include "LeaderboardNameTable.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+using namespace LeaderboardSnapshot;
+
+namespace
+{
+    template <typename T>
+    void AppendRecords(TArray<uint8>& Out, const TArray<T>& Records)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(T));
+    }
+}
+
+// ===== Writer =====
+
+FLeaderboardSnapshotWriter::FLeaderboardSnapshotWriter(const FLeaderboardNameTable& InNameTable, uint32 InPlatform, uint32 InMappingVersion)
+    : NameTable(InNameTable)
+{
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.Platform = InPlatform;
+    Header.MappingVersion = InMappingVersion;
+    StringOffsets.Add(0);
+}
+
+void FLeaderboardSnapshotWriter::BeginBoard(const FString& BoardName, const FDateTime& FetchedAt, int32 LocalPlayerRank)
+{
+    FBoardRecord& Board = BoardRecords.AddDefaulted_GetRef();
+    Board.NameString = AddString(BoardName);
+    Board.FirstRange = RangeRecords.Num();
+    Board.LocalPlayerRank = LocalPlayerRank;
+    Board.FetchedAtTicks = FetchedAt.GetTicks();
+}
+
+void FLeaderboardSnapshotWriter::AddRange(int32 RankFirst, int32 RankCount, TArrayView<const FLeaderboardRow> Rows)
+{
+    check(BoardRecords.Num() > 0);
+    ++BoardRecords.Last().NumRanges;
+
+    FRangeRecord& Range = RangeRecords.AddDefaulted_GetRef();
+    Range.RankFirst = RankFirst;
+    Range.RankCount = RankCount;
+    Range.FirstRow = RowRecords.Num();
+    Range.NumRows = Rows.Num();
+
+    for (const FLeaderboardRow& Row : Rows)
+    {
+        FRowRecord& Record = RowRecords.AddDefaulted_GetRef();
+        Record.Score = Row.Score;
+        Record.Rank = Row.Rank;
+        Record.PlayerIdString = AddHandle(Row.PlayerHandle);
+        Record.PlayerNameString = AddHandle(Row.NameHandle);
+    }
+}
+
+int32 FLeaderboardSnapshotWriter::AddString(const FString& String)
+{
+    FTCHARToUTF8 Utf8(*String);
+    StringBytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+    StringOffsets.Add(StringBytes.Num());
+    return StringOffsets.Num() - 2;
+}
+
+int32 FLeaderboardSnapshotWriter::AddHandle(int32 Handle)
+{
+    if (const int32* Existing = StringByHandle.Find(Handle))
+    {
+        return *Existing;
+    }
+    const int32 Index = AddString(NameTable.Get(Handle));
+    StringByHandle.Add(Handle, Index);
+    return Index;
+}
+
+TArray<uint8> FLeaderboardSnapshotWriter::Finish(const FDateTime& SavedAt)
+{
+    Header.SavedAtTicks = SavedAt.GetTicks();
+    Header.NumBoards = BoardRecords.Num();
+    Header.NumRanges = RangeRecords.Num();
+    Header.NumRows = RowRecords.Num();
+    Header.NumStrings = StringOffsets.Num() - 1;
+    Header.StringBytes = StringBytes.Num();
+
+    TArray<uint8> Out;
+    Out.Reserve(sizeof(FHeader) + BoardRecords.Num() * sizeof(FBoardRecord) + RangeRecords.Num() * sizeof(FRangeRecord)
+        + RowRecords.Num() * sizeof(FRowRecord) + StringOffsets.Num() * sizeof(uint32) + StringBytes.Num());
+    Out.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+    AppendRecords(Out, BoardRecords);
+    AppendRecords(Out, RangeRecords);
+    AppendRecords(Out, RowRecords);
+    AppendRecords(Out, StringOffsets);
+    Out.Append(StringBytes);
+
+    reinterpret_cast<FHeader*>(Out.GetData())->PayloadCrc = FCrc::MemCrc32(Out.GetData() + sizeof(FHeader), Out.Num() - sizeof(FHeader));
+    return Out;
+}
+
+// ===== Reader =====
+
+FLeaderboardSnapshotReader::FLeaderboardSnapshotReader()
+{
+}
+
+FLeaderboardSnapshotReader::~FLeaderboardSnapshotReader()
+{
+    // The region has to go before the handle it was mapped from
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
+
+bool FLeaderboardSnapshotReader::Open(const FString& Path)
+{
+    int64 Size = 0;
+    MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+    if (MappedHandle.IsValid())
+    {
+        MappedRegion.Reset(MappedHandle->MapRegion());
+        if (MappedRegion.IsValid())
+        {
+            Data = MappedRegion->GetMappedPtr();
+            Size = MappedRegion->GetMappedSize();
+        }
+    }
+
+    if (!Data)
+    {
+        MappedRegion.Reset();
+        MappedHandle.Reset();
+        if (!FFileHelper::LoadFileToArray(LoadedBytes, *Path, FILEREAD_Silent))
+        {
+            return false;
+        }
+        Data = LoadedBytes.GetData();
+        Size = LoadedBytes.Num();
+    }
+
+    return Validate(Size);
+}
+
+bool FLeaderboardSnapshotReader::Validate(int64 Size)
+{
+    if (!Data || Size < static_cast<int64>(sizeof(FHeader)) || Size > MAX_int32)
+    {
+        return false;
+    }
+
+    const FHeader* Candidate = reinterpret_cast<const FHeader*>(Data);
+    if (Candidate->Magic != Magic || Candidate->Version != Version || Candidate->NumBoards < 0 || Candidate->NumRanges < 0
+        || Candidate->NumRows < 0 || Candidate->NumStrings < 0 || Candidate->StringBytes < 0)
+    {
+        return false;
+    }
+
+    const int64 BoardsOffset = sizeof(FHeader);
+    const int64 RangesOffset = BoardsOffset + int64(Candidate->NumBoards) * sizeof(FBoardRecord);
+    const int64 RowsOffset = RangesOffset + int64(Candidate->NumRanges) * sizeof(FRangeRecord);
+    const int64 OffsetsOffset = RowsOffset + int64(Candidate->NumRows) * sizeof(FRowRecord);
+    const int64 StringsOffset = OffsetsOffset + (int64(Candidate->NumStrings) + 1) * sizeof(uint32);
+    if (StringsOffset + Candidate->StringBytes != Size
+        || FCrc::MemCrc32(Data + sizeof(FHeader), static_cast<int32>(Size - sizeof(FHeader))) != Candidate->PayloadCrc)
+    {
+        return false;
+    }
+
+    Header = Candidate;
+    Boards = MakeArrayView(reinterpret_cast<const FBoardRecord*>(Data + BoardsOffset), Header->NumBoards);
+    Ranges = MakeArrayView(reinterpret_cast<const FRangeRecord*>(Data + RangesOffset), Header->NumRanges);
+    Rows = MakeArrayView(reinterpret_cast<const FRowRecord*>(Data + RowsOffset), Header->NumRows);
+    StringOffsets = reinterpret_cast<const uint32*>(Data + OffsetsOffset);
+    StringData = Data + StringsOffset;
+
+    // Records are trusted from here on, so every cross reference is checked once up front
+    for (const FBoardRecord& Board : Boards)
+    {
+        if (Board.NameString < 0 || Board.NameString >= Header->NumStrings || Board.FirstRange < 0 || Board.NumRanges < 0
+            || int64(Board.FirstRange) + Board.NumRanges > Header->NumRanges)
+        {
+            Header = nullptr;
+            return false;
+        }
+    }
+    for (const FRangeRecord& Range : Ranges)
+    {
+        // Ranks stay addressable as int32 up to the end of the range, which the store relies on when it merges it
+        const int64 RankEnd = int64(Range.RankFirst) + Range.RankCount;
+        if (Range.RankFirst < 1 || Range.RankCount < 1 || Range.RankCount > MaxRankCount || RankEnd > MAX_int32
+            || Range.FirstRow < 0 || Range.NumRows < 0 || Range.NumRows > Range.RankCount || int64(Range.FirstRow) + Range.NumRows > Header->NumRows)
+        {
+            Header = nullptr;
+            return false;
+        }
+
+        for (const FRowRecord& Row : Rows.Slice(Range.FirstRow, Range.NumRows))
+        {
+            if (Row.Rank < Range.RankFirst || Row.Rank >= RankEnd)
+            {
+                Header = nullptr;
+                return false;
+            }
+        }
+    }
+    for (const FRowRecord& Row : Rows)
+    {
+        if (Row.PlayerIdString < 0 || Row.PlayerIdString >= Header->NumStrings
+            || Row.PlayerNameString < 0 || Row.PlayerNameString >= Header->NumStrings)
+        {
+            Header = nullptr;
+            return false;
+        }
+    }
+    for (int32 Index = 0; Index < Header->NumStrings; ++Index)
+    {
+        if (StringOffsets[Index] > StringOffsets[Index + 1] || StringOffsets[Index + 1] > uint32(Header->StringBytes))
+        {
+            Header = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+FString FLeaderboardSnapshotReader::GetString(int32 Index) const
+{
+    if (!Header || Index < 0 || Index >= Header->NumStrings)
+    {
+        return FString();
+    }
+    const int32 Length = StringOffsets[Index + 1] - StringOffsets[Index];
+    FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(StringData + StringOffsets[Index]), Length);
+    return FString(Converted.Length(), Converted.Get());
+}
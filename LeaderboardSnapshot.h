@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LeaderboardTypes.h"
+
+class FLeaderboardNameTable;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// On-disk copy of the resident global boards. The file is a header followed by fixed-size records and a
+// UTF-8 string blob, all naturally aligned, so a memory-mapped file is read in place. Little-endian only.
+//
+//   FHeader | FBoardRecord[NumBoards] | FRangeRecord[NumRanges] | FRowRecord[NumRows]
+//   | uint32 StringOffsets[NumStrings + 1] | UTF-8 string bytes
+//
+// The header carries a CRC of everything after it, so a file damaged on disk is rejected as a whole.
+namespace LeaderboardSnapshot
+{
+    constexpr uint32 Magic = 0x4E53424C; // "LBSN"
+    constexpr uint32 Version = 2;
+    // Widest range a file may hold. Loading a range allocates its pages, so a corrupt count can't be trusted.
+    constexpr int32 MaxRankCount = 1 << 20;
+
+    struct FHeader
+    {
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        uint32 Platform = 0;
+        uint32 MappingVersion = 0;
+        int64 SavedAtTicks = 0;
+        int32 NumBoards = 0;
+        int32 NumRanges = 0;
+        int32 NumRows = 0;
+        int32 NumStrings = 0;
+        int32 StringBytes = 0;
+        // FCrc::MemCrc32 of every byte after the header
+        uint32 PayloadCrc = 0;
+    };
+
+    struct FBoardRecord
+    {
+        int32 NameString = 0;
+        int32 FirstRange = 0;
+        int32 NumRanges = 0;
+        int32 LocalPlayerRank = -1;
+        int64 FetchedAtTicks = 0;
+    };
+
+    // A rank range a read confirmed, with the rows it held
+    struct FRangeRecord
+    {
+        int32 RankFirst = 0;
+        int32 RankCount = 0;
+        int32 FirstRow = 0;
+        int32 NumRows = 0;
+    };
+
+    struct FRowRecord
+    {
+        int32 Score = 0;
+        int32 Rank = 0;
+        int32 PlayerIdString = 0;
+        int32 PlayerNameString = 0;
+    };
+}
+
+// Builds a snapshot image in memory. Strings are stored once per name table handle.
+class FLeaderboardSnapshotWriter
+{
+public:
+    FLeaderboardSnapshotWriter(const FLeaderboardNameTable& InNameTable, uint32 InPlatform, uint32 InMappingVersion);
+
+    void BeginBoard(const FString& BoardName, const FDateTime& FetchedAt, int32 LocalPlayerRank);
+
+    // Rows must be in rank order and inside the range.
+    void AddRange(int32 RankFirst, int32 RankCount, TArrayView<const FLeaderboardRow> Rows);
+
+    TArray<uint8> Finish(const FDateTime& SavedAt);
+
+private:
+    int32 AddString(const FString& String);
+    int32 AddHandle(int32 Handle);
+
+    const FLeaderboardNameTable& NameTable;
+    LeaderboardSnapshot::FHeader Header;
+    TArray<LeaderboardSnapshot::FBoardRecord> BoardRecords;
+    TArray<LeaderboardSnapshot::FRangeRecord> RangeRecords;
+    TArray<LeaderboardSnapshot::FRowRecord> RowRecords;
+    TArray<uint32> StringOffsets;
+    TArray<uint8> StringBytes;
+    TMap<int32, int32> StringByHandle;
+};
+
+// Read-only view of a snapshot file. Memory-maps it where the platform allows and falls back to one read.
+class FLeaderboardSnapshotReader
+{
+public:
+    FLeaderboardSnapshotReader();
+    ~FLeaderboardSnapshotReader();
+
+    // Opens and validates the file. Fails on a missing, truncated, corrupt or foreign file.
+    bool Open(const FString& Path);
+
+    const LeaderboardSnapshot::FHeader& GetHeader() const { return *Header; }
+    TArrayView<const LeaderboardSnapshot::FBoardRecord> GetBoards() const { return Boards; }
+    TArrayView<const LeaderboardSnapshot::FRangeRecord> GetRanges() const { return Ranges; }
+    TArrayView<const LeaderboardSnapshot::FRowRecord> GetRows() const { return Rows; }
+
+    int32 NumStrings() const { return Header ? Header->NumStrings : 0; }
+    FString GetString(int32 Index) const;
+
+private:
+    bool Validate(int64 Size);
+
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray<uint8> LoadedBytes;
+    const uint8* Data = nullptr;
+
+    const LeaderboardSnapshot::FHeader* Header = nullptr;
+    TArrayView<const LeaderboardSnapshot::FBoardRecord> Boards;
+    TArrayView<const LeaderboardSnapshot::FRangeRecord> Ranges;
+    TArrayView<const LeaderboardSnapshot::FRowRecord> Rows;
+    const uint32* StringOffsets = nullptr;
+    const uint8* StringData = nullptr;
+};
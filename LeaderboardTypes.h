@@ -0,0 +1,212 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "LeaderboardTypes.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLeaderboard, Log, All);
+
+UENUM(BlueprintType)
+enum class ELeaderboardPlatform : uint8
+{
+    Steam,
+    Epic,
+    Null
+};
+
+// Client-side checks a score has to pass before it is queued for the backend. Rejected scores never leave the client.
+USTRUCT(BlueprintType)
+struct FLeaderboardScoreGate
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bLimitScore = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bLimitScore"))
+    int32 MinScore = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bLimitScore"))
+    int32 MaxScore = MAX_int32;
+
+    // Minimum seconds between a player's queued scores on the same board. Scores arriving sooner are held back and the
+    // best of them is queued once the interval is over. 0 disables it.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0"))
+    float MinWriteInterval = 0.0f;
+
+    // Boards keep each player's best, so a score that doesn't beat the best one known locally can't change anything.
+    // Resident rows count as known, and they can be older than the backend's.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bDropNonImprovingScores = false;
+};
+
+USTRUCT(BlueprintType)
+struct FLeaderboardPlatformMappingRow : public FTableRowBase
+{
+    GENERATED_BODY();
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString LeaderboardDisplayName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString SteamLeaderboardName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString SteamStatName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString EpicLeaderboardName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString EpicStatName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FLeaderboardScoreGate ScoreGate;
+};
+
+USTRUCT(BlueprintType)
+struct FLeaderboardEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString PlayerName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Score;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Rank;
+
+    // FUniqueNetId::ToString() of the row's player, or "#<Rank>" when the backend didn't return one.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString PlayerId;
+
+    FLeaderboardEntry()
+        : PlayerName(TEXT("Unknown")), Score(0), Rank(0) {}
+};
+
+USTRUCT(BlueprintType)
+struct FLeaderboardRankRange
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 RankFirst = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 RankCount = 0;
+};
+
+// Where the local player lands on a board, including a score that no read has returned yet.
+USTRUCT(BlueprintType)
+struct FLeaderboardRankProjection
+{
+    GENERATED_BODY()
+
+    // Backend rank, or the estimate from the resident rows while provisional. -1 if there is nothing to go on.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Rank = -1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Score = 0;
+
+    // Set while the score is only known locally; a read that returns it replaces the estimate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bProvisional = false;
+
+    // Rows around the local player in board order, with the rows it passed shifted down one rank
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FLeaderboardEntry> Neighbours;
+};
+
+// One row of a board that differs from what the previous read left in the view. Inserted rows have no old
+// rank, removed rows no new rank.
+USTRUCT(BlueprintType)
+struct FLeaderboardRowChange
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString PlayerId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString PlayerName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 OldRank = -1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 NewRank = -1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 OldScore = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 NewScore = 0;
+};
+
+// What a read changed in a board's view. A row whose score changed is only listed under ScoreChanged even if
+// its rank moved as well.
+USTRUCT(BlueprintType)
+struct FLeaderboardChangeSet
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FLeaderboardRowChange> Inserted;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FLeaderboardRowChange> Removed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FLeaderboardRowChange> RankMoved;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FLeaderboardRowChange> ScoreChanged;
+
+    bool IsEmpty() const
+    {
+        return Inserted.Num() == 0 && Removed.Num() == 0 && RankMoved.Num() == 0 && ScoreChanged.Num() == 0;
+    }
+};
+
+// One player's score in a bulk submission, typically sent by a server for everyone in a match.
+USTRUCT(BlueprintType)
+struct FLeaderboardPlayerScore
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FUniqueNetIdRepl PlayerId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 Score = 0;
+};
+
+// Outcome of one board of a ReadLeaderboards batch.
+USTRUCT(BlueprintType)
+struct FLeaderboardBoardReadStatus
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString LeaderboardName;
+
+    // Request ID of the board's own read, INDEX_NONE if it couldn't be issued
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 RequestId = INDEX_NONE;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bWasSuccessful = false;
+};
+
+// Compact resident row. Player ID and name are handles into the manager's FLeaderboardNameTable.
+struct FLeaderboardRow
+{
+    int32 Score = 0;
+    int32 Rank = 0;
+    int32 PlayerHandle = INDEX_NONE;
+    int32 NameHandle = INDEX_NONE;
+};
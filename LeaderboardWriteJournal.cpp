@@ -0,0 +1,198 @@
+#include "LeaderboardWriteJournal.h"
+#include "LeaderboardTypes.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // Rewrite the file once this many records only describe confirmed submissions
+    constexpr int32 CompactionThreshold = 256;
+
+    // Every record is framed as [uint32 PayloadSize][uint32 PayloadCrc][payload], so a torn tail is detected and dropped
+    constexpr int32 RecordHeaderSize = sizeof(uint32) * 2;
+}
+
+FLeaderboardWriteJournal::~FLeaderboardWriteJournal()
+{
+    Close();
+}
+
+bool FLeaderboardWriteJournal::Open(const FString& Path, TArray<FLeaderboardJournalEntry>& OutOutstanding)
+{
+    Close();
+    Outstanding.Reset();
+    Buffered.Reset();
+    NextSequence = 1;
+    DeadRecords = 0;
+
+    TArray<uint8> Bytes;
+    int32 Offset = 0;
+    if (FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        while (Offset + RecordHeaderSize <= Bytes.Num())
+        {
+            const uint32 PayloadSize = *reinterpret_cast<const uint32*>(Bytes.GetData() + Offset);
+            const uint32 PayloadCrc = *reinterpret_cast<const uint32*>(Bytes.GetData() + Offset + sizeof(uint32));
+            const uint8* Payload = Bytes.GetData() + Offset + RecordHeaderSize;
+            if (Offset + RecordHeaderSize + int64(PayloadSize) > Bytes.Num() || FCrc::MemCrc32(Payload, PayloadSize) != PayloadCrc)
+            {
+                break;
+            }
+
+            TArray<uint8> PayloadBytes(Payload, PayloadSize);
+            FMemoryReader Reader(PayloadBytes);
+            uint8 Type = 0;
+            FLeaderboardJournalEntry Entry;
+            Reader << Type << Entry.Sequence;
+            if (Type == static_cast<uint8>(ERecordType::Submit))
+            {
+                Reader << Entry.SessionName << Entry.UserId << Entry.LeaderboardName << Entry.RatedStat << Entry.StatName << Entry.Score;
+                Outstanding.Add(Entry.Sequence, Entry);
+            }
+            else if (Outstanding.Remove(Entry.Sequence) > 0)
+            {
+                DeadRecords += 2;
+            }
+            NextSequence = FMath::Max(NextSequence, Entry.Sequence + 1);
+            Offset += RecordHeaderSize + PayloadSize;
+        }
+    }
+
+    // A torn tail from a crash mid-write would swallow every later append, so start from a clean file in that case
+    bCompactionRequested = Offset != Bytes.Num() || DeadRecords >= CompactionThreshold;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+    File = MakeShared<FFileState, ESPMode::ThreadSafe>();
+    File->Path = Path;
+    File->Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path, true));
+    if (!File->Handle.IsValid())
+    {
+        UE_LOG(LogLeaderboard, Warning, TEXT("Failed to open leaderboard write journal %s."), *Path);
+        File.Reset();
+        return false;
+    }
+
+    Outstanding.GenerateValueArray(OutOutstanding);
+    OutOutstanding.Sort([](const FLeaderboardJournalEntry& A, const FLeaderboardJournalEntry& B) { return A.Sequence < B.Sequence; });
+    return true;
+}
+
+void FLeaderboardWriteJournal::Close()
+{
+    if (!File.IsValid())
+    {
+        return;
+    }
+    WaitForSync();
+    Sync();
+    WaitForSync();
+    File.Reset();
+}
+
+uint32 FLeaderboardWriteJournal::Append(const FLeaderboardJournalEntry& Entry)
+{
+    FLeaderboardJournalEntry& Stored = Outstanding.Add(NextSequence, Entry);
+    Stored.Sequence = NextSequence++;
+    AppendRecord(Buffered, ERecordType::Submit, Stored);
+    return Stored.Sequence;
+}
+
+void FLeaderboardWriteJournal::Confirm(TArrayView<const uint32> Sequences)
+{
+    for (const uint32 Sequence : Sequences)
+    {
+        if (Outstanding.Remove(Sequence) > 0)
+        {
+            FLeaderboardJournalEntry Entry;
+            Entry.Sequence = Sequence;
+            AppendRecord(Buffered, ERecordType::Confirm, Entry);
+            DeadRecords += 2;
+        }
+    }
+
+    if (DeadRecords > 0 && (Outstanding.Num() == 0 || DeadRecords >= CompactionThreshold))
+    {
+        bCompactionRequested = true;
+    }
+}
+
+void FLeaderboardWriteJournal::AppendRecord(TArray<uint8>& Out, ERecordType Type, FLeaderboardJournalEntry Entry)
+{
+    TArray<uint8> Payload;
+    FMemoryWriter Writer(Payload);
+    uint8 TypeValue = static_cast<uint8>(Type);
+    Writer << TypeValue << Entry.Sequence;
+    if (Type == ERecordType::Submit)
+    {
+        Writer << Entry.SessionName << Entry.UserId << Entry.LeaderboardName << Entry.RatedStat << Entry.StatName << Entry.Score;
+    }
+
+    const uint32 PayloadSize = Payload.Num();
+    const uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+    Out.Append(reinterpret_cast<const uint8*>(&PayloadSize), sizeof(uint32));
+    Out.Append(reinterpret_cast<const uint8*>(&PayloadCrc), sizeof(uint32));
+    Out.Append(Payload);
+}
+
+void FLeaderboardWriteJournal::Sync()
+{
+    if (!File.IsValid() || (SyncTask.IsValid() && !SyncTask.IsReady()) || !HasBufferedRecords())
+    {
+        return;
+    }
+
+    TSharedPtr<FFileState, ESPMode::ThreadSafe> State = File;
+    if (bCompactionRequested)
+    {
+        // The rewritten file holds every outstanding submission, which also covers whatever was buffered
+        TArray<uint32> Sequences;
+        Outstanding.GenerateKeyArray(Sequences);
+        Sequences.Sort();
+        TArray<uint8> Image;
+        for (const uint32 Sequence : Sequences)
+        {
+            AppendRecord(Image, ERecordType::Submit, Outstanding[Sequence]);
+        }
+        Buffered.Reset();
+        bCompactionRequested = false;
+        DeadRecords = 0;
+
+        SyncTask = Async(EAsyncExecution::ThreadPool, [State, Image = MoveTemp(Image)]()
+        {
+            State->Handle.Reset();
+            const FString TempPath = State->Path + TEXT(".tmp");
+            if (!FFileHelper::SaveArrayToFile(Image, *TempPath) || !IFileManager::Get().Move(*State->Path, *TempPath, true, true))
+            {
+                UE_LOG(LogLeaderboard, Warning, TEXT("Failed to compact leaderboard write journal %s."), *State->Path);
+            }
+            State->Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*State->Path, true));
+        });
+        return;
+    }
+
+    SyncTask = Async(EAsyncExecution::ThreadPool, [State, Bytes = MoveTemp(Buffered)]()
+    {
+        if (State->Handle.IsValid() && State->Handle->Write(Bytes.GetData(), Bytes.Num()))
+        {
+            State->Handle->Flush(true);
+        }
+        else
+        {
+            UE_LOG(LogLeaderboard, Warning, TEXT("Failed to append to leaderboard write journal %s."), *State->Path);
+        }
+    });
+    Buffered.Reset();
+}
+
+void FLeaderboardWriteJournal::WaitForSync()
+{
+    if (SyncTask.IsValid())
+    {
+        SyncTask.Wait();
+    }
+}
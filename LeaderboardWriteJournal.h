@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+class IFileHandle;
+
+// A score submission as it is kept in the journal until a flush confirms it.
+struct FLeaderboardJournalEntry
+{
+    uint32 Sequence = 0;
+    FName SessionName;
+    FString UserId;
+    FName LeaderboardName;
+    FName RatedStat;
+    FName StatName;
+    int32 Score = 0;
+};
+
+// Append-only log of score submissions that survives crashes and offline sessions.
+// Appends only go to memory; Sync hands them to a worker that writes and fsyncs the whole batch at once.
+// Confirmed submissions are dropped from the file by rewriting it once enough of it is dead weight.
+class FLeaderboardWriteJournal
+{
+public:
+    ~FLeaderboardWriteJournal();
+
+    // Reads the journal at Path, returns every submission no flush confirmed yet and keeps the file open for appends.
+    bool Open(const FString& Path, TArray<FLeaderboardJournalEntry>& OutOutstanding);
+    // Syncs what is buffered, waits for it and closes the file.
+    void Close();
+    bool IsOpen() const { return File.IsValid(); }
+
+    // Records a submission and returns its sequence number.
+    uint32 Append(const FLeaderboardJournalEntry& Entry);
+
+    // Marks submissions as accepted by the backend.
+    void Confirm(TArrayView<const uint32> Sequences);
+
+    // Starts writing buffered records in the background. Does nothing while the previous batch is still being written.
+    void Sync();
+    void WaitForSync();
+
+    bool HasBufferedRecords() const { return Buffered.Num() > 0 || bCompactionRequested; }
+    int32 NumOutstanding() const { return Outstanding.Num(); }
+
+private:
+    struct FFileState
+    {
+        FString Path;
+        TUniquePtr<IFileHandle> Handle;
+    };
+
+    enum class ERecordType : uint8
+    {
+        Submit,
+        Confirm,
+    };
+
+    static void AppendRecord(TArray<uint8>& Out, ERecordType Type, FLeaderboardJournalEntry Entry);
+
+    TSharedPtr<FFileState, ESPMode::ThreadSafe> File;
+    TArray<uint8> Buffered;
+    TMap<uint32, FLeaderboardJournalEntry> Outstanding;
+    uint32 NextSequence = 1;
+    int32 DeadRecords = 0;
+    bool bCompactionRequested = false;
+    TFuture<void> SyncTask;
+};